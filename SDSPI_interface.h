@@ -0,0 +1,100 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+#ifndef SDSPI_INTERFACE_H
+#define SDSPI_INTERFACE_H
+
+/*************************************************************************************************************
+*	SD card block device over the SPI driver (SD v1, SDSC v2 and SDHC/SDXC cards).							 *
+*																											 *
+*	Sequential reads are served with CMD18 and read ahead into a small cache, writes are queued and		 *
+*	sent with CMD25 after an ACMD23 pre-erase, so a filesystem issuing one sector at a time still gets		 *
+*	multi-block transfers. Queued writes reach the card on SDSPI_u8Sync (or when the queue is full or		 *
+*	the next write is not contiguous), a filesystem sync must call it.										 *
+*	CMD59 data CRC checking is enabled by SDSPI_CRC_ENABLE, command CRCs are always sent.					 *
+*************************************************************************************************************/
+/************************************************* DEFINES *************************************************/
+/** @defgroup SDSPI_Status SDSPI Status
+  * @{
+  */
+#define SDSPI_OK								0U
+#define SDSPI_ERR_TIMEOUT						1U
+#define SDSPI_ERR_BUS							2U
+#define SDSPI_ERR_NO_CARD						3U
+#define SDSPI_ERR_CRC							4U
+#define SDSPI_ERR_WRITE							5U
+#define SDSPI_ERR_PARAM							6U
+/**
+  * @}
+  */
+
+/** @defgroup SDSPI_Card_Type SDSPI Card Type
+  * @{
+  */
+#define SDSPI_CARD_NONE							0U
+#define SDSPI_CARD_V1							1U		/* SD v1, byte addressing							*/
+#define SDSPI_CARD_V2_SC						2U		/* SD v2 standard capacity, byte addressing			*/
+#define SDSPI_CARD_V2_HC						3U		/* SDHC / SDXC, block addressing					*/
+/**
+  * @}
+  */
+
+/** @defgroup SDSPI_Configuration SDSPI Configuration, can be overridden from the build command line
+  * @{
+  */
+#define SDSPI_BLOCK_SIZE						512U
+#ifndef SDSPI_READ_AHEAD_BLOCKS
+#define SDSPI_READ_AHEAD_BLOCKS					4U		/* Blocks fetched by one read ahead, at least 1		*/
+#endif
+#ifndef SDSPI_WRITE_BEHIND_BLOCKS
+#define SDSPI_WRITE_BEHIND_BLOCKS				4U		/* Blocks queued before a write is forced, at least 1	*/
+#endif
+#ifndef SDSPI_CRC_ENABLE
+#define SDSPI_CRC_ENABLE						0U		/* 1 to check the CRC16 of every data block			*/
+#endif
+#ifndef SDSPI_INIT_HZ
+#define SDSPI_INIT_HZ							400000U	/* SCK limit during the card identification			*/
+#endif
+/**
+  * @}
+  */
+/***********************************************************************************************************/
+/************************************************* TYPES ***************************************************/
+/**
+  * @brief  SD card handle, the configuration fields are set by the application before SDSPI_u8Init,
+  *			the others are managed by the driver
+  */
+typedef struct
+{
+	/* Configuration */
+	uint8_t		u8SPIx;													/*!< Bus of the card, a value of @ref SPIx				*/
+	uint32_t	u32PclkHz;												/*!< APB clock feeding the SPI peripheral				*/
+	uint32_t	u32MaxHz;												/*!< SCK limit after the identification, 25 MHz max		*/
+	void		(*pfSelect)(void);										/*!< Drives CS low										*/
+	void		(*pfDeselect)(void);									/*!< Drives CS high										*/
+
+	/* State */
+	uint8_t		u8CardType;												/*!< A value of @ref SDSPI_Card_Type					*/
+	uint8_t		u8Prescaler;											/*!< Data transfer BR, a value of @ref SPI_BaudRate_Prescaler, restored on every bus access	*/
+	uint32_t	u32NextRead;											/*!< Sector following the last read, detects sequential reads	*/
+	uint32_t	u32ReadAheadSector;										/*!< First sector held by the read ahead cache			*/
+	uint32_t	u32ReadAheadCount;										/*!< Sectors held by the read ahead cache				*/
+	uint32_t	u32WriteSector;											/*!< First sector of the write queue					*/
+	uint32_t	u32WriteCount;											/*!< Sectors in the write queue							*/
+	uint32_t	u32PreEraseSector;										/*!< First sector of the area announced by SDSPI_vPreEraseHint	*/
+	uint32_t	u32PreEraseCount;										/*!< Sectors of that area not written yet				*/
+	uint8_t		au8ReadAhead[SDSPI_READ_AHEAD_BLOCKS][SDSPI_BLOCK_SIZE];
+	uint8_t		au8WriteBehind[SDSPI_WRITE_BEHIND_BLOCKS][SDSPI_BLOCK_SIZE];
+}SDSPI_Card_t;
+/***********************************************************************************************************/
+/************************************************* PROTOTYPES **********************************************/
+uint8_t SDSPI_u8Init(SDSPI_Card_t* Copy_pxCard);
+uint8_t SDSPI_u8Read(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, uint8_t* Copy_pu8Data, uint32_t Copy_u32Count);
+uint8_t SDSPI_u8Write(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, const uint8_t* Copy_pu8Data, uint32_t Copy_u32Count);
+uint8_t SDSPI_u8Sync(SDSPI_Card_t* Copy_pxCard);
+void SDSPI_vPreEraseHint(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, uint32_t Copy_u32Blocks);
+/***********************************************************************************************************/
+#endif
@@ -0,0 +1,876 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+#include <stdint.h>
+#include "../06-STK/STK_module.h"
+#include "SPI_interface.h"
+#include "SDSPI_interface.h"
+#include "SDSPI_private.h"
+
+static_assert((SDSPI_READ_AHEAD_BLOCKS >= 1U) && (SDSPI_WRITE_BEHIND_BLOCKS >= 1U), "SDSPI caches need at least one block");
+
+/**
+ * @fn uint8_t SDSPI_u8Crc7(const uint8_t*, uint8_t)
+ * @brief Compute the CRC7 of a command frame
+ *
+ * @param Copy_pu8Data		Pointer to the command bytes
+ * @param Copy_u8Length		Number of bytes
+ *
+ * @retval CRC7 shifted left with the end bit set, ready to be sent as the last command byte
+ */
+static uint8_t SDSPI_u8Crc7(const uint8_t* Copy_pu8Data, uint8_t Copy_u8Length)
+{
+	uint8_t Loc_u8Crc = 0U;
+	uint8_t Loc_u8Index, Loc_u8Bit;
+
+	for(Loc_u8Index = 0U; Loc_u8Index < Copy_u8Length; Loc_u8Index++)
+	{
+		uint8_t Loc_u8Data = Copy_pu8Data[Loc_u8Index];
+
+		for(Loc_u8Bit = 0U; Loc_u8Bit < 8U; Loc_u8Bit++)
+		{
+			Loc_u8Crc <<= 1;
+			if(((Loc_u8Data ^ Loc_u8Crc) & 0x80U) != 0U)
+			{
+				Loc_u8Crc ^= 0x09U;
+			}
+			Loc_u8Data <<= 1;
+		}
+	}
+
+	return (uint8_t)((Loc_u8Crc << 1) | 1U);
+}
+
+/**
+ * @fn uint16_t SDSPI_u16Crc16(const uint8_t*, uint16_t)
+ * @brief Compute the CRC16-CCITT of a data block
+ *
+ * @param Copy_pu8Data		Pointer to the data block
+ * @param Copy_u16Length	Number of bytes
+ *
+ * @retval CRC16
+ */
+static uint16_t SDSPI_u16Crc16(const uint8_t* Copy_pu8Data, uint16_t Copy_u16Length)
+{
+	uint16_t Loc_u16Crc = 0U;
+	uint16_t Loc_u16Index;
+
+	for(Loc_u16Index = 0U; Loc_u16Index < Copy_u16Length; Loc_u16Index++)
+	{
+		Loc_u16Crc  = (uint16_t)((Loc_u16Crc >> 8) | (Loc_u16Crc << 8));
+		Loc_u16Crc ^= Copy_pu8Data[Loc_u16Index];
+		Loc_u16Crc ^= (uint16_t)((Loc_u16Crc & 0xFFU) >> 4);
+		Loc_u16Crc ^= (uint16_t)(Loc_u16Crc << 12);
+		Loc_u16Crc ^= (uint16_t)((Loc_u16Crc & 0xFFU) << 5);
+	}
+
+	return Loc_u16Crc;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8Exchange(SDSPI_Card_t*, uint8_t*, uint16_t)
+ * @brief Send a buffer and replace it in place by the received bytes
+ *
+ * @param Copy_pxCard		Pointer to the card
+ * @param Copy_pu8Buffer	Pointer to the buffer
+ * @param Copy_u16Length	Number of bytes
+ *
+ * @retval Transfer status, a value of @ref SPI_Status
+ */
+static uint8_t SDSPI_u8Exchange(SDSPI_Card_t* Copy_pxCard, uint8_t* Copy_pu8Buffer, uint16_t Copy_u16Length)
+{
+	SPI_vTransmitReceive(Copy_pxCard -> u8SPIx, Copy_pu8Buffer, Copy_pu8Buffer, Copy_u16Length, SPI_DATASIZE_8BIT, SDSPI_XFER_TIMEOUT_US);
+
+	return SPI_u8GetLastStatus(Copy_pxCard -> u8SPIx);
+}
+
+/**
+ * @fn uint8_t SDSPI_u8Byte(SDSPI_Card_t*, uint8_t)
+ * @brief Exchange one byte with the card
+ *
+ * @param Copy_pxCard		Pointer to the card
+ * @param Copy_u8Data		Byte to send
+ *
+ * @retval Received byte
+ */
+static uint8_t SDSPI_u8Byte(SDSPI_Card_t* Copy_pxCard, uint8_t Copy_u8Data)
+{
+	SDSPI_u8Exchange(Copy_pxCard, &Copy_u8Data, 1U);
+
+	return Copy_u8Data;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8SendData(SDSPI_Card_t*, const uint8_t*, uint16_t)
+ * @brief Send a buffer that must be kept intact, through a small scratch buffer
+ *
+ * @param Copy_pxCard		Pointer to the card
+ * @param Copy_pu8Data		Pointer to the data
+ * @param Copy_u16Length	Number of bytes
+ *
+ * @retval Transfer status, a value of @ref SPI_Status
+ */
+static uint8_t SDSPI_u8SendData(SDSPI_Card_t* Copy_pxCard, const uint8_t* Copy_pu8Data, uint16_t Copy_u16Length)
+{
+	uint8_t Loc_au8Chunk[SDSPI_TX_CHUNK];
+	uint8_t Loc_u8Status = SPI_STATUS_OK;
+
+	while((Copy_u16Length > 0U) && (Loc_u8Status == SPI_STATUS_OK))
+	{
+		uint16_t Loc_u16Length = (Copy_u16Length < SDSPI_TX_CHUNK) ? Copy_u16Length : SDSPI_TX_CHUNK;
+		uint16_t Loc_u16Index;
+
+		for(Loc_u16Index = 0U; Loc_u16Index < Loc_u16Length; Loc_u16Index++)
+		{
+			Loc_au8Chunk[Loc_u16Index] = Copy_pu8Data[Loc_u16Index];
+		}
+
+		Loc_u8Status = SDSPI_u8Exchange(Copy_pxCard, Loc_au8Chunk, Loc_u16Length);
+
+		Copy_pu8Data += Loc_u16Length;
+		Copy_u16Length -= Loc_u16Length;
+	}
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn bool SDSPI_boolWaitReady(SDSPI_Card_t*, uint32_t)
+ * @brief Wait until the card releases its busy signal (DO held low)
+ *
+ * @param Copy_pxCard		Pointer to the card
+ * @param Copy_u32Timeout	Timeout in microseconds
+ *
+ * @retval true if the card is ready
+ */
+static bool SDSPI_boolWaitReady(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Timeout)
+{
+	uint64_t Loc_u64tickstart = micros();
+	bool Loc_boolReady = false;
+
+	do
+	{
+		Loc_boolReady = (SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE) == SDSPI_DUMMY_BYTE);
+	}while((Loc_boolReady == false) && ((micros() - Loc_u64tickstart) < Copy_u32Timeout));
+
+	return Loc_boolReady;
+}
+
+/**
+ * @fn void SDSPI_vSelect(SDSPI_Card_t*)
+ * @brief Assert CS, followed by one clock byte
+ *
+ * @retval None
+ */
+static void SDSPI_vSelect(SDSPI_Card_t* Copy_pxCard)
+{
+	Copy_pxCard -> pfSelect();
+	SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE);
+}
+
+/**
+ * @fn void SDSPI_vDeselect(SDSPI_Card_t*)
+ * @brief Release CS, followed by one clock byte so the card releases DO
+ *
+ * @retval None
+ */
+static void SDSPI_vDeselect(SDSPI_Card_t* Copy_pxCard)
+{
+	Copy_pxCard -> pfDeselect();
+	SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE);
+}
+
+/**
+ * @fn bool SDSPI_boolAcquire(SDSPI_Card_t*)
+ * @brief Take the bus and restore the card configuration, another driver sharing the bus may
+ * have changed the mode or the prescaler since the last access
+ *
+ * @param Copy_pxCard		Pointer to the card
+ *
+ * @retval true if the bus is owned, release it with SPI_vRelease
+ */
+static bool SDSPI_boolAcquire(SDSPI_Card_t* Copy_pxCard)
+{
+	bool Loc_boolAcquired = SPI_boolAcquire(Copy_pxCard -> u8SPIx, SDSPI_WRITE_TIMEOUT_US);
+
+	if(Loc_boolAcquired == true)
+	{
+		SPI_vInit(Copy_pxCard -> u8SPIx, SPI_MODE_MASTER, SPI_DATASIZE_8BIT, SPI_POLARITY_LOW, SPI_PHASE_1EDGE, SPI_SSM_SW_MANAGE, SPI_SSI_HIGH,
+				SPI_SSOE_OUTPUT_DIS, Copy_pxCard -> u8Prescaler, SPI_FIRSTBIT_MSB);
+	}
+
+	return Loc_boolAcquired;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8Command(SDSPI_Card_t*, uint8_t, uint32_t)
+ * @brief Send a command and return its R1 response, the card stays selected.
+ * CMD12 is sent inside the running read, every other command starts a new chip select window.
+ *
+ * @param Copy_pxCard			Pointer to the card
+ * @param Copy_u8Command		Command index
+ * @param Copy_u32Argument		Command argument
+ *
+ * @retval R1 response, SDSPI_R1_INVALID if the card did not answer
+ */
+static uint8_t SDSPI_u8Command(SDSPI_Card_t* Copy_pxCard, uint8_t Copy_u8Command, uint32_t Copy_u32Argument)
+{
+	uint8_t Loc_au8Frame[6];
+	uint8_t Loc_u8R1 = SDSPI_R1_INVALID;
+	uint8_t Loc_u8Try;
+
+	if(Copy_u8Command != SDSPI_CMD12_STOP_TRANSMISSION)
+	{
+		SDSPI_vDeselect(Copy_pxCard);
+		SDSPI_vSelect(Copy_pxCard);
+
+		if((Copy_u8Command != SDSPI_CMD0_GO_IDLE_STATE) && (SDSPI_boolWaitReady(Copy_pxCard, SDSPI_WRITE_TIMEOUT_US) == false))
+		{
+			return Loc_u8R1;
+		}
+	}
+
+	Loc_au8Frame[0] = (uint8_t)(0x40U | Copy_u8Command);
+	Loc_au8Frame[1] = (uint8_t)(Copy_u32Argument >> 24);
+	Loc_au8Frame[2] = (uint8_t)(Copy_u32Argument >> 16);
+	Loc_au8Frame[3] = (uint8_t)(Copy_u32Argument >> 8);
+	Loc_au8Frame[4] = (uint8_t)(Copy_u32Argument);
+	Loc_au8Frame[5] = SDSPI_u8Crc7(Loc_au8Frame, 5U);
+
+	SDSPI_u8Exchange(Copy_pxCard, Loc_au8Frame, 6U);
+
+	/* Skip the stuff byte following CMD12 */
+	if(Copy_u8Command == SDSPI_CMD12_STOP_TRANSMISSION)
+	{
+		SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE);
+	}
+
+	/* R1 comes within 8 bytes, its MSB is cleared */
+	for(Loc_u8Try = 0U; (Loc_u8Try < 10U) && ((Loc_u8R1 & 0x80U) != 0U); Loc_u8Try++)
+	{
+		Loc_u8R1 = SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE);
+	}
+
+	return Loc_u8R1;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8AppCommand(SDSPI_Card_t*, uint8_t, uint32_t)
+ * @brief Send an application specific command (CMD55 prefix)
+ *
+ * @retval R1 response of the command
+ */
+static uint8_t SDSPI_u8AppCommand(SDSPI_Card_t* Copy_pxCard, uint8_t Copy_u8Command, uint32_t Copy_u32Argument)
+{
+	uint8_t Loc_u8R1 = SDSPI_u8Command(Copy_pxCard, SDSPI_CMD55_APP_CMD, 0U);
+
+	if(Loc_u8R1 <= SDSPI_R1_IDLE)
+	{
+		Loc_u8R1 = SDSPI_u8Command(Copy_pxCard, Copy_u8Command, Copy_u32Argument);
+	}
+
+	return Loc_u8R1;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8ReadBlocks(SDSPI_Card_t*, uint32_t, uint8_t*, uint32_t)
+ * @brief Read consecutive blocks from the card, CMD17 for one block, CMD18 + CMD12 for several
+ *
+ * @param Copy_pxCard		Pointer to the card
+ * @param Copy_u32Sector	First sector
+ * @param Copy_pu8Data		Pointer to the reception buffer, Copy_u32Count x SDSPI_BLOCK_SIZE bytes
+ * @param Copy_u32Count		Number of blocks
+ *
+ * @retval A value of @ref SDSPI_Status
+ */
+static uint8_t SDSPI_u8ReadBlocks(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, uint8_t* Copy_pu8Data, uint32_t Copy_u32Count)
+{
+	uint8_t Loc_u8Status = SDSPI_OK;
+	uint32_t Loc_u32Address = (Copy_pxCard -> u8CardType == SDSPI_CARD_V2_HC) ? Copy_u32Sector : (Copy_u32Sector * SDSPI_BLOCK_SIZE);
+	uint8_t Loc_u8R1 = SDSPI_u8Command(Copy_pxCard, (Copy_u32Count == 1U) ? SDSPI_CMD17_READ_SINGLE_BLOCK : SDSPI_CMD18_READ_MULTIPLE_BLOCK,
+			Loc_u32Address);
+
+	if(Loc_u8R1 != SDSPI_R1_READY)
+	{
+		Loc_u8Status = ((Loc_u8R1 & SDSPI_R1_CRC_ERROR) != 0U) ? SDSPI_ERR_CRC : SDSPI_ERR_TIMEOUT;
+		Copy_u32Count = 0U;
+	}
+
+	for(uint32_t Loc_u32Block = 0U; (Loc_u32Block < Copy_u32Count) && (Loc_u8Status == SDSPI_OK); Loc_u32Block++)
+	{
+		uint64_t Loc_u64tickstart = micros();
+		uint8_t Loc_u8Token;
+		uint8_t Loc_au8Crc[2] = {SDSPI_DUMMY_BYTE, SDSPI_DUMMY_BYTE};
+		uint16_t Loc_u16Index;
+
+		/* Wait for the start block token */
+		do
+		{
+			Loc_u8Token = SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE);
+		}while((Loc_u8Token == SDSPI_DUMMY_BYTE) && ((micros() - Loc_u64tickstart) < SDSPI_READ_TIMEOUT_US));
+
+		if(Loc_u8Token != SDSPI_TOKEN_START_BLOCK)
+		{
+			Loc_u8Status = SDSPI_ERR_TIMEOUT;
+			break;
+		}
+
+		/* Dummy bytes are sent from the buffer itself */
+		for(Loc_u16Index = 0U; Loc_u16Index < SDSPI_BLOCK_SIZE; Loc_u16Index++)
+		{
+			Copy_pu8Data[Loc_u16Index] = SDSPI_DUMMY_BYTE;
+		}
+
+		if((SDSPI_u8Exchange(Copy_pxCard, Copy_pu8Data, SDSPI_BLOCK_SIZE) != SPI_STATUS_OK) ||
+		   (SDSPI_u8Exchange(Copy_pxCard, Loc_au8Crc, 2U) != SPI_STATUS_OK))
+		{
+			Loc_u8Status = SDSPI_ERR_BUS;
+			break;
+		}
+
+#if SDSPI_CRC_ENABLE
+		if(SDSPI_u16Crc16(Copy_pu8Data, SDSPI_BLOCK_SIZE) != (uint16_t)((Loc_au8Crc[0] << 8) | Loc_au8Crc[1]))
+		{
+			Loc_u8Status = SDSPI_ERR_CRC;
+			break;
+		}
+#endif
+
+		Copy_pu8Data += SDSPI_BLOCK_SIZE;
+	}
+
+	if((Loc_u8R1 == SDSPI_R1_READY) && (Copy_u32Count > 1U))
+	{
+		SDSPI_u8Command(Copy_pxCard, SDSPI_CMD12_STOP_TRANSMISSION, 0U);
+		SDSPI_boolWaitReady(Copy_pxCard, SDSPI_WRITE_TIMEOUT_US);
+	}
+
+	SDSPI_vDeselect(Copy_pxCard);
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8WriteBlocks(SDSPI_Card_t*, uint32_t, const uint8_t*, uint32_t)
+ * @brief Write consecutive blocks to the card, CMD24 for one block,
+ * ACMD23 pre-erase + CMD25 + stop token for several
+ *
+ * @param Copy_pxCard		Pointer to the card
+ * @param Copy_u32Sector	First sector
+ * @param Copy_pu8Data		Pointer to the data, Copy_u32Count x SDSPI_BLOCK_SIZE bytes
+ * @param Copy_u32Count		Number of blocks
+ *
+ * @retval A value of @ref SDSPI_Status
+ */
+static uint8_t SDSPI_u8WriteBlocks(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, const uint8_t* Copy_pu8Data, uint32_t Copy_u32Count)
+{
+	uint8_t Loc_u8Status = SDSPI_OK;
+	uint32_t Loc_u32Address = (Copy_pxCard -> u8CardType == SDSPI_CARD_V2_HC) ? Copy_u32Sector : (Copy_u32Sector * SDSPI_BLOCK_SIZE);
+	bool Loc_boolMulti = (Copy_u32Count > 1U);
+	uint8_t Loc_u8R1;
+
+	/* Pre-erased blocks that are not written get undefined contents, so only a write starting inside
+	 * the announced area may pre-erase past its own blocks, and never past the end of that area */
+	bool Loc_boolInArea = (Copy_u32Sector >= Copy_pxCard -> u32PreEraseSector) &&
+						  ((Copy_u32Sector - Copy_pxCard -> u32PreEraseSector) < Copy_pxCard -> u32PreEraseCount);
+	uint32_t Loc_u32AreaEnd = Copy_pxCard -> u32PreEraseSector + Copy_pxCard -> u32PreEraseCount;
+
+	if(Loc_boolMulti == true)
+	{
+		uint32_t Loc_u32PreErase = Copy_u32Count;
+
+		if((Loc_boolInArea == true) && ((Loc_u32AreaEnd - Copy_u32Sector) > Copy_u32Count))
+		{
+			Loc_u32PreErase = Loc_u32AreaEnd - Copy_u32Sector;
+		}
+		if(Loc_u32PreErase > SDSPI_ACMD23_MAX_BLOCKS)
+		{
+			Loc_u32PreErase = SDSPI_ACMD23_MAX_BLOCKS;
+		}
+
+		SDSPI_u8AppCommand(Copy_pxCard, SDSPI_ACMD23_SET_WR_BLK_ERASE_COUNT, Loc_u32PreErase);
+		Loc_u8R1 = SDSPI_u8Command(Copy_pxCard, SDSPI_CMD25_WRITE_MULTIPLE_BLOCK, Loc_u32Address);
+	}
+	else
+	{
+		Loc_u8R1 = SDSPI_u8Command(Copy_pxCard, SDSPI_CMD24_WRITE_BLOCK, Loc_u32Address);
+	}
+
+	/* The rest of the area starts after the written blocks */
+	if(Loc_boolInArea == true)
+	{
+		uint32_t Loc_u32Written = ((Loc_u32AreaEnd - Copy_u32Sector) > Copy_u32Count) ? Copy_u32Count : (Loc_u32AreaEnd - Copy_u32Sector);
+
+		Copy_pxCard -> u32PreEraseSector = Copy_u32Sector + Loc_u32Written;
+		Copy_pxCard -> u32PreEraseCount = Loc_u32AreaEnd - Copy_pxCard -> u32PreEraseSector;
+	}
+
+	if(Loc_u8R1 != SDSPI_R1_READY)
+	{
+		SDSPI_vDeselect(Copy_pxCard);
+		return ((Loc_u8R1 & SDSPI_R1_CRC_ERROR) != 0U) ? SDSPI_ERR_CRC : SDSPI_ERR_TIMEOUT;
+	}
+
+	for(uint32_t Loc_u32Block = 0U; (Loc_u32Block < Copy_u32Count) && (Loc_u8Status == SDSPI_OK); Loc_u32Block++)
+	{
+		uint16_t Loc_u16Crc = SDSPI_CRC_ENABLE ? SDSPI_u16Crc16(Copy_pu8Data, SDSPI_BLOCK_SIZE) : 0xFFFFU;
+		uint8_t Loc_au8Crc[2] = {(uint8_t)(Loc_u16Crc >> 8), (uint8_t)Loc_u16Crc};
+		uint8_t Loc_u8Response;
+
+		/* The card is busy programming the previous block */
+		if(SDSPI_boolWaitReady(Copy_pxCard, SDSPI_WRITE_TIMEOUT_US) == false)
+		{
+			Loc_u8Status = SDSPI_ERR_TIMEOUT;
+			break;
+		}
+
+		SDSPI_u8Byte(Copy_pxCard, (Loc_boolMulti == true) ? SDSPI_TOKEN_START_MULTI_WRITE : SDSPI_TOKEN_START_BLOCK);
+
+		if((SDSPI_u8SendData(Copy_pxCard, Copy_pu8Data, SDSPI_BLOCK_SIZE) != SPI_STATUS_OK) ||
+		   (SDSPI_u8Exchange(Copy_pxCard, Loc_au8Crc, 2U) != SPI_STATUS_OK))
+		{
+			Loc_u8Status = SDSPI_ERR_BUS;
+			break;
+		}
+
+		Loc_u8Response = SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE) & SDSPI_DATA_RESPONSE_MASK;
+		if(Loc_u8Response != SDSPI_DATA_ACCEPTED)
+		{
+			Loc_u8Status = (Loc_u8Response == SDSPI_DATA_CRC_ERROR) ? SDSPI_ERR_CRC : SDSPI_ERR_WRITE;
+			break;
+		}
+
+		Copy_pu8Data += SDSPI_BLOCK_SIZE;
+	}
+
+	if(Loc_boolMulti == true)
+	{
+		SDSPI_boolWaitReady(Copy_pxCard, SDSPI_WRITE_TIMEOUT_US);
+		SDSPI_u8Byte(Copy_pxCard, SDSPI_TOKEN_STOP_TRAN);
+		SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE);
+	}
+
+	/* Wait the end of the programming */
+	if((SDSPI_boolWaitReady(Copy_pxCard, SDSPI_WRITE_TIMEOUT_US) == false) && (Loc_u8Status == SDSPI_OK))
+	{
+		Loc_u8Status = SDSPI_ERR_TIMEOUT;
+	}
+
+	SDSPI_vDeselect(Copy_pxCard);
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8Flush(SDSPI_Card_t*)
+ * @brief Send the write queue to the card in one multi-block write, the queue is kept on failure.
+ * The read ahead cache is dropped, it may hold the contents the queued sectors had before
+ *
+ * @retval A value of @ref SDSPI_Status
+ */
+static uint8_t SDSPI_u8Flush(SDSPI_Card_t* Copy_pxCard)
+{
+	uint8_t Loc_u8Status = SDSPI_OK;
+
+	if(Copy_pxCard -> u32WriteCount != 0U)
+	{
+		Copy_pxCard -> u32ReadAheadCount = 0U;
+		Loc_u8Status = SDSPI_u8WriteBlocks(Copy_pxCard, Copy_pxCard -> u32WriteSector, &Copy_pxCard -> au8WriteBehind[0][0], Copy_pxCard -> u32WriteCount);
+
+		if(Loc_u8Status == SDSPI_OK)
+		{
+			Copy_pxCard -> u32WriteCount = 0U;
+		}
+	}
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8Init(SDSPI_Card_t*)
+ * @brief Initialize the SPI bus and identify the card (CMD0, CMD8, ACMD41, CMD58), then switch
+ * the bus to the fastest prescaler allowed by u32MaxHz. The configuration fields of the handle
+ * must be set before the call.
+ *
+ * @param Copy_pxCard		Pointer to the card
+ *
+ * @retval A value of @ref SDSPI_Status
+ */
+uint8_t SDSPI_u8Init(SDSPI_Card_t* Copy_pxCard)
+{
+	uint8_t Loc_u8Status = SDSPI_OK;
+	uint8_t Loc_u8SlowBR, Loc_u8FastBR;
+	uint8_t Loc_u8R1 = SDSPI_R1_INVALID;
+	uint8_t Loc_u8Index;
+	uint8_t Loc_au8Response[4];
+
+	if((Copy_pxCard == nullptr) || (Copy_pxCard -> pfSelect == nullptr) || (Copy_pxCard -> pfDeselect == nullptr))
+	{
+		return SDSPI_ERR_PARAM;
+	}
+
+	Loc_u8SlowBR = SPI_u8SelectPrescaler(Copy_pxCard -> u32PclkHz, SDSPI_INIT_HZ, SPI_PROCESS_TX_RX, SPI_TRANSFER_POLLING, SPI_MODE_MASTER, SPI_DATASIZE_8BIT);
+	Loc_u8FastBR = SPI_u8SelectPrescaler(Copy_pxCard -> u32PclkHz, Copy_pxCard -> u32MaxHz, SPI_PROCESS_TX_RX, SPI_TRANSFER_POLLING, SPI_MODE_MASTER, SPI_DATASIZE_8BIT);
+
+	if((Loc_u8SlowBR == SPI_CLOCK_RATE_INVALID) || (Loc_u8FastBR == SPI_CLOCK_RATE_INVALID))
+	{
+		return SDSPI_ERR_PARAM;
+	}
+
+	Copy_pxCard -> u8CardType			= SDSPI_CARD_NONE;
+	Copy_pxCard -> u8Prescaler			= Loc_u8SlowBR;
+	Copy_pxCard -> u32NextRead			= 0xFFFFFFFFU;
+	Copy_pxCard -> u32ReadAheadCount	= 0U;
+	Copy_pxCard -> u32WriteCount		= 0U;
+	Copy_pxCard -> u32PreEraseSector	= 0U;
+	Copy_pxCard -> u32PreEraseCount		= 0U;
+
+	if(SPI_boolAcquire(Copy_pxCard -> u8SPIx, SDSPI_WRITE_TIMEOUT_US) == false)
+	{
+		return SDSPI_ERR_BUS;
+	}
+
+	SPI_vInit(Copy_pxCard -> u8SPIx, SPI_MODE_MASTER, SPI_DATASIZE_8BIT, SPI_POLARITY_LOW, SPI_PHASE_1EDGE, SPI_SSM_SW_MANAGE, SPI_SSI_HIGH,
+			SPI_SSOE_OUTPUT_DIS, Loc_u8SlowBR, SPI_FIRSTBIT_MSB);
+
+	/* At least 74 clocks with CS high to enter the native mode */
+	Copy_pxCard -> pfDeselect();
+	for(Loc_u8Index = 0U; Loc_u8Index < 10U; Loc_u8Index++)
+	{
+		SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE);
+	}
+
+	/* Software reset, enters the SPI mode */
+	for(Loc_u8Index = 0U; (Loc_u8Index < 10U) && (Loc_u8R1 != SDSPI_R1_IDLE); Loc_u8Index++)
+	{
+		Loc_u8R1 = SDSPI_u8Command(Copy_pxCard, SDSPI_CMD0_GO_IDLE_STATE, 0U);
+	}
+
+	if(Loc_u8R1 != SDSPI_R1_IDLE)
+	{
+		Loc_u8Status = SDSPI_ERR_NO_CARD;
+	}
+	else
+	{
+		uint8_t Loc_u8Type = SDSPI_CARD_NONE;
+
+		/* Interface condition, only answered by v2 cards */
+		Loc_u8R1 = SDSPI_u8Command(Copy_pxCard, SDSPI_CMD8_SEND_IF_COND, SDSPI_CMD8_CHECK_PATTERN);
+
+		if(Loc_u8R1 == SDSPI_R1_IDLE)
+		{
+			for(Loc_u8Index = 0U; Loc_u8Index < 4U; Loc_u8Index++)
+			{
+				Loc_au8Response[Loc_u8Index] = SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE);
+			}
+			if((((uint16_t)(Loc_au8Response[2] & 0x0FU) << 8) | Loc_au8Response[3]) == SDSPI_CMD8_CHECK_PATTERN)
+			{
+				Loc_u8Type = SDSPI_CARD_V2_SC;
+			}
+		}
+		else if((Loc_u8R1 & SDSPI_R1_ILLEGAL_COMMAND) != 0U)
+		{
+			Loc_u8Type = SDSPI_CARD_V1;
+		}
+		else
+		{
+
+		}
+
+#if SDSPI_CRC_ENABLE
+		if(Loc_u8Type != SDSPI_CARD_NONE)
+		{
+			SDSPI_u8Command(Copy_pxCard, SDSPI_CMD59_CRC_ON_OFF, 1U);
+		}
+#endif
+
+		/* Leave the idle state, announcing high capacity support to v2 cards */
+		if(Loc_u8Type != SDSPI_CARD_NONE)
+		{
+			uint64_t Loc_u64tickstart = micros();
+
+			do
+			{
+				Loc_u8R1 = SDSPI_u8AppCommand(Copy_pxCard, SDSPI_ACMD41_SD_SEND_OP_COND, (Loc_u8Type == SDSPI_CARD_V2_SC) ? SDSPI_ACMD41_HCS : 0U);
+			}while((Loc_u8R1 == SDSPI_R1_IDLE) && ((micros() - Loc_u64tickstart) < SDSPI_INIT_TIMEOUT_US));
+
+			if(Loc_u8R1 != SDSPI_R1_READY)
+			{
+				Loc_u8Type = SDSPI_CARD_NONE;
+			}
+		}
+
+		/* Card capacity status, block or byte addressing */
+		if((Loc_u8Type == SDSPI_CARD_V2_SC) && (SDSPI_u8Command(Copy_pxCard, SDSPI_CMD58_READ_OCR, 0U) == SDSPI_R1_READY))
+		{
+			for(Loc_u8Index = 0U; Loc_u8Index < 4U; Loc_u8Index++)
+			{
+				Loc_au8Response[Loc_u8Index] = SDSPI_u8Byte(Copy_pxCard, SDSPI_DUMMY_BYTE);
+			}
+			if((Loc_au8Response[0] & (uint8_t)(SDSPI_OCR_CCS >> 24)) != 0U)
+			{
+				Loc_u8Type = SDSPI_CARD_V2_HC;
+			}
+		}
+
+		if((Loc_u8Type == SDSPI_CARD_V1) || (Loc_u8Type == SDSPI_CARD_V2_SC))
+		{
+			if(SDSPI_u8Command(Copy_pxCard, SDSPI_CMD16_SET_BLOCKLEN, SDSPI_BLOCK_SIZE) != SDSPI_R1_READY)
+			{
+				Loc_u8Type = SDSPI_CARD_NONE;
+			}
+		}
+
+		Copy_pxCard -> u8CardType = Loc_u8Type;
+		Loc_u8Status = (Loc_u8Type == SDSPI_CARD_NONE) ? SDSPI_ERR_NO_CARD : SDSPI_OK;
+	}
+
+	SDSPI_vDeselect(Copy_pxCard);
+
+	if(Loc_u8Status == SDSPI_OK)
+	{
+		SPI_vInit(Copy_pxCard -> u8SPIx, SPI_MODE_MASTER, SPI_DATASIZE_8BIT, SPI_POLARITY_LOW, SPI_PHASE_1EDGE, SPI_SSM_SW_MANAGE, SPI_SSI_HIGH,
+				SPI_SSOE_OUTPUT_DIS, Loc_u8FastBR, SPI_FIRSTBIT_MSB);
+		Copy_pxCard -> u8Prescaler = Loc_u8FastBR;
+	}
+
+	SPI_vRelease(Copy_pxCard -> u8SPIx);
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8Read(SDSPI_Card_t*, uint32_t, uint8_t*, uint32_t)
+ * @brief Read sectors. Long reads go straight to the caller buffer in one CMD18, short reads that
+ * continue the previous one fetch SDSPI_READ_AHEAD_BLOCKS sectors at once and are served from
+ * that cache until it runs out.
+ *
+ * @param Copy_pxCard		Pointer to the card
+ * @param Copy_u32Sector	First sector
+ * @param Copy_pu8Data		Pointer to the reception buffer, Copy_u32Count x SDSPI_BLOCK_SIZE bytes
+ * @param Copy_u32Count		Number of sectors
+ *
+ * @retval A value of @ref SDSPI_Status
+ */
+uint8_t SDSPI_u8Read(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, uint8_t* Copy_pu8Data, uint32_t Copy_u32Count)
+{
+	uint8_t Loc_u8Status = SDSPI_OK;
+
+	if((Copy_pxCard == nullptr) || (Copy_pu8Data == nullptr) || (Copy_pxCard -> u8CardType == SDSPI_CARD_NONE))
+	{
+		return SDSPI_ERR_PARAM;
+	}
+
+	if(SDSPI_boolAcquire(Copy_pxCard) == false)
+	{
+		return SDSPI_ERR_BUS;
+	}
+
+	/* Queued writes over the requested sectors must reach the card first */
+	if((Copy_pxCard -> u32WriteCount != 0U) &&
+	   (Copy_u32Sector < (Copy_pxCard -> u32WriteSector + Copy_pxCard -> u32WriteCount)) &&
+	   (Copy_pxCard -> u32WriteSector < (Copy_u32Sector + Copy_u32Count)))
+	{
+		Loc_u8Status = SDSPI_u8Flush(Copy_pxCard);
+	}
+
+	while((Copy_u32Count > 0U) && (Loc_u8Status == SDSPI_OK))
+	{
+		uint32_t Loc_u32Done;
+
+		if((Copy_u32Sector >= Copy_pxCard -> u32ReadAheadSector) &&
+		   (Copy_u32Sector < (Copy_pxCard -> u32ReadAheadSector + Copy_pxCard -> u32ReadAheadCount)))
+		{
+			/* Cache hit */
+			uint32_t Loc_u32Offset = Copy_u32Sector - Copy_pxCard -> u32ReadAheadSector;
+			const uint8_t* Loc_pu8Src = &Copy_pxCard -> au8ReadAhead[Loc_u32Offset][0];
+			uint32_t Loc_u32Byte;
+
+			Loc_u32Done = Copy_pxCard -> u32ReadAheadCount - Loc_u32Offset;
+			if(Loc_u32Done > Copy_u32Count)
+			{
+				Loc_u32Done = Copy_u32Count;
+			}
+
+			for(Loc_u32Byte = 0U; Loc_u32Byte < (Loc_u32Done * SDSPI_BLOCK_SIZE); Loc_u32Byte++)
+			{
+				Copy_pu8Data[Loc_u32Byte] = Loc_pu8Src[Loc_u32Byte];
+			}
+		}
+		else if((Copy_u32Count < SDSPI_READ_AHEAD_BLOCKS) && (Copy_u32Sector == Copy_pxCard -> u32NextRead))
+		{
+			/* Short sequential read, fetch ahead into the cache and serve it on the next loop */
+			Copy_pxCard -> u32ReadAheadCount = 0U;
+			Loc_u32Done = 0U;
+
+			/* Queued writes inside the fetched sectors must reach the card first, the cache would keep their old contents */
+			if((Copy_pxCard -> u32WriteCount != 0U) &&
+			   (Copy_u32Sector < (Copy_pxCard -> u32WriteSector + Copy_pxCard -> u32WriteCount)) &&
+			   (Copy_pxCard -> u32WriteSector < (Copy_u32Sector + SDSPI_READ_AHEAD_BLOCKS)))
+			{
+				Loc_u8Status = SDSPI_u8Flush(Copy_pxCard);
+			}
+
+			if(Loc_u8Status != SDSPI_OK)
+			{
+
+			}
+			else if(SDSPI_u8ReadBlocks(Copy_pxCard, Copy_u32Sector, &Copy_pxCard -> au8ReadAhead[0][0], SDSPI_READ_AHEAD_BLOCKS) == SDSPI_OK)
+			{
+				Copy_pxCard -> u32ReadAheadSector = Copy_u32Sector;
+				Copy_pxCard -> u32ReadAheadCount = SDSPI_READ_AHEAD_BLOCKS;
+			}
+			else
+			{
+				/* Read ahead may run past the end of the card, fall back to the requested sectors */
+				Loc_u8Status = SDSPI_u8ReadBlocks(Copy_pxCard, Copy_u32Sector, Copy_pu8Data, Copy_u32Count);
+				Loc_u32Done = Copy_u32Count;
+			}
+		}
+		else
+		{
+			/* Long or random read, straight to the caller buffer */
+			Loc_u8Status = SDSPI_u8ReadBlocks(Copy_pxCard, Copy_u32Sector, Copy_pu8Data, Copy_u32Count);
+			Loc_u32Done = Copy_u32Count;
+		}
+
+		Copy_u32Sector += Loc_u32Done;
+		Copy_pu8Data += Loc_u32Done * SDSPI_BLOCK_SIZE;
+		Copy_u32Count -= Loc_u32Done;
+	}
+
+	Copy_pxCard -> u32NextRead = Copy_u32Sector;
+
+	SPI_vRelease(Copy_pxCard -> u8SPIx);
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8Write(SDSPI_Card_t*, uint32_t, const uint8_t*, uint32_t)
+ * @brief Write sectors. Short writes are queued while they stay contiguous and are sent in one
+ * multi-block write when the queue is full, when a non contiguous sector is written, on a read
+ * of a queued sector or on SDSPI_u8Sync. Long writes go straight to the card in one CMD25.
+ *
+ * @param Copy_pxCard		Pointer to the card
+ * @param Copy_u32Sector	First sector
+ * @param Copy_pu8Data		Pointer to the data, Copy_u32Count x SDSPI_BLOCK_SIZE bytes
+ * @param Copy_u32Count		Number of sectors
+ *
+ * @retval A value of @ref SDSPI_Status, errors of queued sectors may be reported by a later call
+ */
+uint8_t SDSPI_u8Write(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, const uint8_t* Copy_pu8Data, uint32_t Copy_u32Count)
+{
+	uint8_t Loc_u8Status = SDSPI_OK;
+
+	if((Copy_pxCard == nullptr) || (Copy_pu8Data == nullptr) || (Copy_pxCard -> u8CardType == SDSPI_CARD_NONE))
+	{
+		return SDSPI_ERR_PARAM;
+	}
+
+	if(SDSPI_boolAcquire(Copy_pxCard) == false)
+	{
+		return SDSPI_ERR_BUS;
+	}
+
+	/* The read ahead cache must not serve stale sectors */
+	if((Copy_u32Sector < (Copy_pxCard -> u32ReadAheadSector + Copy_pxCard -> u32ReadAheadCount)) &&
+	   (Copy_pxCard -> u32ReadAheadSector < (Copy_u32Sector + Copy_u32Count)))
+	{
+		Copy_pxCard -> u32ReadAheadCount = 0U;
+	}
+
+	while((Copy_u32Count > 0U) && (Loc_u8Status == SDSPI_OK))
+	{
+		uint32_t Loc_u32Done = 0U;
+
+		if((Copy_pxCard -> u32WriteCount != 0U) &&
+		   ((Copy_u32Sector != (Copy_pxCard -> u32WriteSector + Copy_pxCard -> u32WriteCount)) ||
+			(Copy_pxCard -> u32WriteCount == SDSPI_WRITE_BEHIND_BLOCKS)))
+		{
+			Loc_u8Status = SDSPI_u8Flush(Copy_pxCard);
+		}
+		else if((Copy_pxCard -> u32WriteCount == 0U) && (Copy_u32Count >= SDSPI_WRITE_BEHIND_BLOCKS))
+		{
+			Loc_u8Status = SDSPI_u8WriteBlocks(Copy_pxCard, Copy_u32Sector, Copy_pu8Data, Copy_u32Count);
+			Loc_u32Done = Copy_u32Count;
+		}
+		else
+		{
+			uint8_t* Loc_pu8Dst = &Copy_pxCard -> au8WriteBehind[Copy_pxCard -> u32WriteCount][0];
+			uint16_t Loc_u16Byte;
+
+			for(Loc_u16Byte = 0U; Loc_u16Byte < SDSPI_BLOCK_SIZE; Loc_u16Byte++)
+			{
+				Loc_pu8Dst[Loc_u16Byte] = Copy_pu8Data[Loc_u16Byte];
+			}
+			if(Copy_pxCard -> u32WriteCount == 0U)
+			{
+				Copy_pxCard -> u32WriteSector = Copy_u32Sector;
+			}
+			Copy_pxCard -> u32WriteCount++;
+			Loc_u32Done = 1U;
+		}
+
+		Copy_u32Sector += Loc_u32Done;
+		Copy_pu8Data += Loc_u32Done * SDSPI_BLOCK_SIZE;
+		Copy_u32Count -= Loc_u32Done;
+	}
+
+	SPI_vRelease(Copy_pxCard -> u8SPIx);
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn uint8_t SDSPI_u8Sync(SDSPI_Card_t*)
+ * @brief Send the queued writes to the card and wait for their programming
+ *
+ * @param Copy_pxCard		Pointer to the card
+ *
+ * @retval A value of @ref SDSPI_Status
+ */
+uint8_t SDSPI_u8Sync(SDSPI_Card_t* Copy_pxCard)
+{
+	uint8_t Loc_u8Status = SDSPI_OK;
+
+	if((Copy_pxCard == nullptr) || (Copy_pxCard -> u8CardType == SDSPI_CARD_NONE))
+	{
+		return SDSPI_ERR_PARAM;
+	}
+
+	if(SDSPI_boolAcquire(Copy_pxCard) == false)
+	{
+		return SDSPI_ERR_BUS;
+	}
+
+	Loc_u8Status = SDSPI_u8Flush(Copy_pxCard);
+
+	SPI_vRelease(Copy_pxCard -> u8SPIx);
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn void SDSPI_vPreEraseHint(SDSPI_Card_t*, uint32_t, uint32_t)
+ * @brief Announce an area about to be written sequentially (for example a file of known size).
+ * A multi-block write starting inside the area pre-erases with ACMD23 up to the end of the area,
+ * every other write pre-erases only its own blocks. A new hint replaces the previous one.
+ *
+ * @param Copy_pxCard		Pointer to the card
+ * @param Copy_u32Sector	First sector of the area
+ * @param Copy_u32Blocks	Number of sectors of the area, 0 cancels the hint
+ *
+ * @retval None
+ */
+void SDSPI_vPreEraseHint(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, uint32_t Copy_u32Blocks)
+{
+	if(Copy_pxCard != nullptr)
+	{
+		Copy_pxCard -> u32PreEraseSector = Copy_u32Sector;
+		Copy_pxCard -> u32PreEraseCount = Copy_u32Blocks;
+	}
+}
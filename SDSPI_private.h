@@ -0,0 +1,73 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+#ifndef SDSPI_PRIVATE_H
+#define SDSPI_PRIVATE_H
+
+/* Commands */
+#define SDSPI_CMD0_GO_IDLE_STATE			0U
+#define SDSPI_CMD8_SEND_IF_COND				8U
+#define SDSPI_CMD12_STOP_TRANSMISSION		12U
+#define SDSPI_CMD16_SET_BLOCKLEN			16U
+#define SDSPI_CMD17_READ_SINGLE_BLOCK		17U
+#define SDSPI_CMD18_READ_MULTIPLE_BLOCK		18U
+#define SDSPI_CMD24_WRITE_BLOCK				24U
+#define SDSPI_CMD25_WRITE_MULTIPLE_BLOCK	25U
+#define SDSPI_CMD55_APP_CMD					55U
+#define SDSPI_CMD58_READ_OCR				58U
+#define SDSPI_CMD59_CRC_ON_OFF				59U
+#define SDSPI_ACMD23_SET_WR_BLK_ERASE_COUNT	23U
+#define SDSPI_ACMD41_SD_SEND_OP_COND		41U
+
+/* R1 response */
+#define SDSPI_R1_READY						0x00U
+#define SDSPI_R1_IDLE						0x01U
+#define SDSPI_R1_ILLEGAL_COMMAND			0x04U
+#define SDSPI_R1_CRC_ERROR					0x08U
+#define SDSPI_R1_INVALID					0xFFU
+
+/* Data tokens */
+#define SDSPI_TOKEN_START_BLOCK				0xFEU
+#define SDSPI_TOKEN_START_MULTI_WRITE		0xFCU
+#define SDSPI_TOKEN_STOP_TRAN				0xFDU
+#define SDSPI_DATA_RESPONSE_MASK			0x1FU
+#define SDSPI_DATA_ACCEPTED					0x05U
+#define SDSPI_DATA_CRC_ERROR				0x0BU
+
+#define SDSPI_CMD8_CHECK_PATTERN			0x000001AAU
+#define SDSPI_ACMD41_HCS					0x40000000U
+#define SDSPI_ACMD23_MAX_BLOCKS				0x007FFFFFU
+#define SDSPI_OCR_CCS						0x40000000U
+#define SDSPI_DUMMY_BYTE					0xFFU
+
+/* Timeouts */
+#define SDSPI_INIT_TIMEOUT_US				1000000U
+#define SDSPI_READ_TIMEOUT_US				100000U
+#define SDSPI_WRITE_TIMEOUT_US				500000U
+/* Bound of one SPI transfer. The master clocks the card, so the transfer never waits for it and the
+ * bound only catches a stuck peripheral. The wire time is not usable here: the polling loop spends
+ * more PCLK cycles per byte than the wire at the fast prescalers, and the task may be preempted */
+#define SDSPI_XFER_TIMEOUT_US				SDSPI_READ_TIMEOUT_US
+
+/* Bytes copied per SPI transfer when sending data that must not be overwritten by the received bytes */
+#define SDSPI_TX_CHUNK						64U
+
+static uint8_t SDSPI_u8Crc7(const uint8_t* Copy_pu8Data, uint8_t Copy_u8Length);
+static uint16_t SDSPI_u16Crc16(const uint8_t* Copy_pu8Data, uint16_t Copy_u16Length);
+static uint8_t SDSPI_u8Exchange(SDSPI_Card_t* Copy_pxCard, uint8_t* Copy_pu8Buffer, uint16_t Copy_u16Length);
+static uint8_t SDSPI_u8Byte(SDSPI_Card_t* Copy_pxCard, uint8_t Copy_u8Data);
+static uint8_t SDSPI_u8SendData(SDSPI_Card_t* Copy_pxCard, const uint8_t* Copy_pu8Data, uint16_t Copy_u16Length);
+static bool SDSPI_boolWaitReady(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Timeout);
+static bool SDSPI_boolAcquire(SDSPI_Card_t* Copy_pxCard);
+static void SDSPI_vSelect(SDSPI_Card_t* Copy_pxCard);
+static void SDSPI_vDeselect(SDSPI_Card_t* Copy_pxCard);
+static uint8_t SDSPI_u8Command(SDSPI_Card_t* Copy_pxCard, uint8_t Copy_u8Command, uint32_t Copy_u32Argument);
+static uint8_t SDSPI_u8AppCommand(SDSPI_Card_t* Copy_pxCard, uint8_t Copy_u8Command, uint32_t Copy_u32Argument);
+static uint8_t SDSPI_u8ReadBlocks(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, uint8_t* Copy_pu8Data, uint32_t Copy_u32Count);
+static uint8_t SDSPI_u8WriteBlocks(SDSPI_Card_t* Copy_pxCard, uint32_t Copy_u32Sector, const uint8_t* Copy_pu8Data, uint32_t Copy_u32Count);
+static uint8_t SDSPI_u8Flush(SDSPI_Card_t* Copy_pxCard);
+
+#endif
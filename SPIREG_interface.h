@@ -0,0 +1,89 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+#ifndef SPIREG_INTERFACE_H
+#define SPIREG_INTERFACE_H
+
+/*************************************************************************************************************
+*	Batched register access for sensor devices (IMU, pressure, ...) on top of the SPI driver.				 *
+*																											 *
+*	A batch is a list of register reads and writes. Consecutive reads are sorted by address and merged		 *
+*	into bursts, small holes between them are read and dropped when it saves a chip select window.			 *
+*	Reads of the same or overlapping registers are not merged, each one reaches the device.					 *
+*	Consecutive writes to adjacent addresses are merged keeping their order. Every burst is one chip		 *
+*	select window, and the whole batch runs with the bus lock held.											 *
+*																											 *
+*	   CS  ---\____________________________/-------\____________________/---								 *
+*	   MOSI    | ADDR|R|INC | dummy ...    |       | ADDR|W|INC | data  |									 *
+*	   MISO    |            | data ...     |       |            |       |									 *
+*************************************************************************************************************/
+/************************************************* DEFINES *************************************************/
+/** @defgroup SPIREG_Access SPIREG Access
+  * @{
+  */
+#define SPIREG_READ								0U
+#define SPIREG_WRITE							1U
+/**
+  * @}
+  */
+
+/** @defgroup SPIREG_Status SPIREG Status, extends @ref SPI_Status
+  * @{
+  */
+#define SPIREG_STATUS_INVALID					SPI_STATUS_INVALID
+/**
+  * @}
+  */
+
+/** @defgroup SPIREG_Configuration SPIREG Configuration, can be overridden from the build command line
+  * @{
+  */
+#ifndef SPIREG_BURST_MAX
+#define SPIREG_BURST_MAX						32U		/* Registers transferred in one chip select window	*/
+#endif
+#ifndef SPIREG_BATCH_MAX
+#define SPIREG_BATCH_MAX						32U		/* Operations in one batch							*/
+#endif
+/**
+  * @}
+  */
+/***********************************************************************************************************/
+/************************************************* TYPES ***************************************************/
+/**
+  * @brief  Addressing rules of a register based device
+  */
+typedef struct
+{
+	uint8_t		u8SPIx;								/*!< Bus of the device, a value of @ref SPIx								*/
+	uint8_t		u8ReadMask;							/*!< OR'ed into the address byte of a read, for example 0x80				*/
+	uint8_t		u8WriteMask;						/*!< OR'ed into the address byte of a write, usually 0x00					*/
+	uint8_t		u8IncrementMask;					/*!< OR'ed into the address byte of a burst to enable auto-increment, for
+														 example 0x40, 0x00 when the device always increments					*/
+	bool		boolAutoIncrement;					/*!< Device supports multi-register bursts									*/
+	uint8_t		u8MaxGap;							/*!< Unrequested registers that may be read to merge two reads in one burst,
+														 0 when reading some registers has side effects (FIFO, clear on read)	*/
+	uint32_t	u32Timeout;							/*!< Timeout of one burst, also bounds the wait for the bus lock			*/
+	void		(*pfSelect)(void);					/*!< Drives CS low, nullptr when NSS is managed by hardware					*/
+	void		(*pfDeselect)(void);				/*!< Drives CS high, nullptr when NSS is managed by hardware				*/
+}SPIREG_Device_t;
+
+/**
+  * @brief  One register access of a batch
+  */
+typedef struct
+{
+	uint8_t		u8Address;							/*!< First register address, without the read/write/increment bits		*/
+	uint8_t		u8Access;							/*!< A value of @ref SPIREG_Access											*/
+	uint8_t		u8Length;							/*!< Registers accessed from u8Address, 1 to SPIREG_BURST_MAX				*/
+	uint8_t*	pu8Data;							/*!< Read destination or write source, u8Length bytes						*/
+}SPIREG_Op_t;
+/***********************************************************************************************************/
+/************************************************* PROTOTYPES **********************************************/
+uint8_t SPIREG_u8Batch(const SPIREG_Device_t* Copy_pxDevice, const SPIREG_Op_t* Copy_pxOps, uint8_t Copy_u8OpsNo);
+uint8_t SPIREG_u8Read(const SPIREG_Device_t* Copy_pxDevice, uint8_t Copy_u8Address, uint8_t* Copy_pu8Data, uint8_t Copy_u8Length);
+uint8_t SPIREG_u8Write(const SPIREG_Device_t* Copy_pxDevice, uint8_t Copy_u8Address, uint8_t* Copy_pu8Data, uint8_t Copy_u8Length);
+/***********************************************************************************************************/
+#endif
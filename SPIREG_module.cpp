@@ -0,0 +1,293 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+#include <stdint.h>
+#include "SPI_interface.h"
+#include "SPIREG_interface.h"
+#include "SPIREG_private.h"
+
+/**
+ * @fn uint8_t SPIREG_u8Transfer(const SPIREG_Device_t*, uint8_t*, uint8_t)
+ * @brief Run one chip select window, the frame is sent and replaced in place by the received bytes
+ *
+ * @param Copy_pxDevice		Pointer to the device
+ * @param Copy_pu8Frame		Pointer to the address byte followed by the data bytes
+ * @param Copy_u8Length		Frame length in bytes, address byte included
+ *
+ * @retval Transfer status, a value of @ref SPI_Status
+ */
+static uint8_t SPIREG_u8Transfer(const SPIREG_Device_t* Copy_pxDevice, uint8_t* Copy_pu8Frame, uint8_t Copy_u8Length)
+{
+	if(Copy_pxDevice -> pfSelect != nullptr)
+	{
+		Copy_pxDevice -> pfSelect();
+	}
+
+	SPI_vTransmitReceive(Copy_pxDevice -> u8SPIx, Copy_pu8Frame, Copy_pu8Frame, Copy_u8Length, SPI_DATASIZE_8BIT, Copy_pxDevice -> u32Timeout);
+
+	if(Copy_pxDevice -> pfDeselect != nullptr)
+	{
+		Copy_pxDevice -> pfDeselect();
+	}
+
+	return SPI_u8GetLastStatus(Copy_pxDevice -> u8SPIx);
+}
+
+/**
+ * @fn uint8_t SPIREG_u8ReadRun(const SPIREG_Device_t*, const SPIREG_Op_t*, uint8_t)
+ * @brief Execute consecutive read operations, sorted by address and merged into as few bursts as possible.
+ * Reads of the same or overlapping registers are never merged, they run in their batch order
+ *
+ * @param Copy_pxDevice		Pointer to the device
+ * @param Copy_pxOps		Pointer to the first read operation
+ * @param Copy_u8OpsNo		Number of read operations
+ *
+ * @retval Transfer status, a value of @ref SPI_Status
+ */
+static uint8_t SPIREG_u8ReadRun(const SPIREG_Device_t* Copy_pxDevice, const SPIREG_Op_t* Copy_pxOps, uint8_t Copy_u8OpsNo)
+{
+	uint8_t Loc_u8Status = SPI_STATUS_OK;
+	uint8_t Loc_au8Order[SPIREG_BATCH_MAX];
+	uint8_t Loc_au8Frame[SPIREG_BURST_MAX + 1U];
+	uint8_t Loc_u8Index, Loc_u8Next;
+
+	/* Sort the reads by address (insertion sort, batches are short) */
+	for(Loc_u8Index = 0U; Loc_u8Index < Copy_u8OpsNo; Loc_u8Index++)
+	{
+		uint8_t Loc_u8Pos = Loc_u8Index;
+
+		while((Loc_u8Pos > 0U) && (Copy_pxOps[Loc_au8Order[Loc_u8Pos - 1U]].u8Address > Copy_pxOps[Loc_u8Index].u8Address))
+		{
+			Loc_au8Order[Loc_u8Pos] = Loc_au8Order[Loc_u8Pos - 1U];
+			Loc_u8Pos--;
+		}
+		Loc_au8Order[Loc_u8Pos] = Loc_u8Index;
+	}
+
+	for(Loc_u8Index = 0U; (Loc_u8Index < Copy_u8OpsNo) && (Loc_u8Status == SPI_STATUS_OK); Loc_u8Index = Loc_u8Next)
+	{
+		const SPIREG_Op_t* Loc_pxFirst = &Copy_pxOps[Loc_au8Order[Loc_u8Index]];
+		uint16_t Loc_u16Start = Loc_pxFirst -> u8Address;
+		uint16_t Loc_u16End = Loc_u16Start + Loc_pxFirst -> u8Length;
+
+		/* Grow the burst with the next reads while they are close enough and the burst fits. A read of a
+		 * register already in the burst gets its own window: each read of a FIFO or clear on read
+		 * register must reach the device */
+		for(Loc_u8Next = Loc_u8Index + 1U; Loc_u8Next < Copy_u8OpsNo; Loc_u8Next++)
+		{
+			const SPIREG_Op_t* Loc_pxOp = &Copy_pxOps[Loc_au8Order[Loc_u8Next]];
+			uint16_t Loc_u16OpEnd = Loc_pxOp -> u8Address + Loc_pxOp -> u8Length;
+
+			if((Copy_pxDevice -> boolAutoIncrement == false) || (Loc_pxOp -> u8Address < Loc_u16End) ||
+			   (Loc_pxOp -> u8Address > (Loc_u16End + Copy_pxDevice -> u8MaxGap)) ||
+			   ((uint16_t)(Loc_u16OpEnd - Loc_u16Start) > SPIREG_BURST_MAX))
+			{
+				break;
+			}
+			Loc_u16End = Loc_u16OpEnd;
+		}
+
+		if((Copy_pxDevice -> boolAutoIncrement == false) && (Loc_pxFirst -> u8Length > 1U))
+		{
+			/* No burst support, one chip select window per register */
+			uint8_t Loc_u8Reg;
+
+			for(Loc_u8Reg = 0U; (Loc_u8Reg < Loc_pxFirst -> u8Length) && (Loc_u8Status == SPI_STATUS_OK); Loc_u8Reg++)
+			{
+				Loc_au8Frame[0] = (uint8_t)(Loc_pxFirst -> u8Address + Loc_u8Reg) | Copy_pxDevice -> u8ReadMask;
+				Loc_au8Frame[1] = SPIREG_DUMMY_BYTE;
+				Loc_u8Status = SPIREG_u8Transfer(Copy_pxDevice, Loc_au8Frame, 2U);
+				Loc_pxFirst -> pu8Data[Loc_u8Reg] = Loc_au8Frame[1];
+			}
+		}
+		else
+		{
+			uint8_t Loc_u8Length = (uint8_t)(Loc_u16End - Loc_u16Start);
+			uint8_t Loc_u8Byte;
+
+			Loc_au8Frame[0] = (uint8_t)Loc_u16Start | Copy_pxDevice -> u8ReadMask | ((Loc_u8Length > 1U) ? Copy_pxDevice -> u8IncrementMask : 0U);
+			for(Loc_u8Byte = 1U; Loc_u8Byte <= Loc_u8Length; Loc_u8Byte++)
+			{
+				Loc_au8Frame[Loc_u8Byte] = SPIREG_DUMMY_BYTE;
+			}
+
+			Loc_u8Status = SPIREG_u8Transfer(Copy_pxDevice, Loc_au8Frame, Loc_u8Length + 1U);
+
+			/* Scatter the burst to the merged reads */
+			uint8_t Loc_u8Op;
+			for(Loc_u8Op = Loc_u8Index; Loc_u8Op < Loc_u8Next; Loc_u8Op++)
+			{
+				const SPIREG_Op_t* Loc_pxOp = &Copy_pxOps[Loc_au8Order[Loc_u8Op]];
+				const uint8_t* Loc_pu8Src = &Loc_au8Frame[1U + Loc_pxOp -> u8Address - Loc_u16Start];
+
+				for(Loc_u8Byte = 0U; Loc_u8Byte < Loc_pxOp -> u8Length; Loc_u8Byte++)
+				{
+					Loc_pxOp -> pu8Data[Loc_u8Byte] = Loc_pu8Src[Loc_u8Byte];
+				}
+			}
+		}
+	}
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn uint8_t SPIREG_u8WriteRun(const SPIREG_Device_t*, const SPIREG_Op_t*, uint8_t)
+ * @brief Execute consecutive write operations in order, writes to adjacent addresses share one burst
+ *
+ * @param Copy_pxDevice		Pointer to the device
+ * @param Copy_pxOps		Pointer to the first write operation
+ * @param Copy_u8OpsNo		Number of write operations
+ *
+ * @retval Transfer status, a value of @ref SPI_Status
+ */
+static uint8_t SPIREG_u8WriteRun(const SPIREG_Device_t* Copy_pxDevice, const SPIREG_Op_t* Copy_pxOps, uint8_t Copy_u8OpsNo)
+{
+	uint8_t Loc_u8Status = SPI_STATUS_OK;
+	uint8_t Loc_au8Frame[SPIREG_BURST_MAX + 1U];
+	uint8_t Loc_u8Index = 0U;
+
+	while((Loc_u8Index < Copy_u8OpsNo) && (Loc_u8Status == SPI_STATUS_OK))
+	{
+		uint16_t Loc_u16Start = Copy_pxOps[Loc_u8Index].u8Address;
+		uint8_t Loc_u8Length = 0U;
+		uint8_t Loc_u8Byte;
+
+		if(Copy_pxDevice -> boolAutoIncrement == false)
+		{
+			/* No burst support, one chip select window per register */
+			const SPIREG_Op_t* Loc_pxOp = &Copy_pxOps[Loc_u8Index];
+
+			for(Loc_u8Byte = 0U; (Loc_u8Byte < Loc_pxOp -> u8Length) && (Loc_u8Status == SPI_STATUS_OK); Loc_u8Byte++)
+			{
+				Loc_au8Frame[0] = (uint8_t)(Loc_pxOp -> u8Address + Loc_u8Byte) | Copy_pxDevice -> u8WriteMask;
+				Loc_au8Frame[1] = Loc_pxOp -> pu8Data[Loc_u8Byte];
+				Loc_u8Status = SPIREG_u8Transfer(Copy_pxDevice, Loc_au8Frame, 2U);
+			}
+			Loc_u8Index++;
+			continue;
+		}
+
+		/* Append the writes that continue exactly where the burst ends */
+		while((Loc_u8Index < Copy_u8OpsNo) &&
+			  (Copy_pxOps[Loc_u8Index].u8Address == (Loc_u16Start + Loc_u8Length)) &&
+			  ((Loc_u8Length + Copy_pxOps[Loc_u8Index].u8Length) <= SPIREG_BURST_MAX))
+		{
+			for(Loc_u8Byte = 0U; Loc_u8Byte < Copy_pxOps[Loc_u8Index].u8Length; Loc_u8Byte++)
+			{
+				Loc_au8Frame[1U + Loc_u8Length + Loc_u8Byte] = Copy_pxOps[Loc_u8Index].pu8Data[Loc_u8Byte];
+			}
+			Loc_u8Length += Copy_pxOps[Loc_u8Index].u8Length;
+			Loc_u8Index++;
+		}
+
+		Loc_au8Frame[0] = (uint8_t)Loc_u16Start | Copy_pxDevice -> u8WriteMask | ((Loc_u8Length > 1U) ? Copy_pxDevice -> u8IncrementMask : 0U);
+
+		Loc_u8Status = SPIREG_u8Transfer(Copy_pxDevice, Loc_au8Frame, Loc_u8Length + 1U);
+	}
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn uint8_t SPIREG_u8Batch(const SPIREG_Device_t*, const SPIREG_Op_t*, uint8_t)
+ * @brief Execute a batch of register reads and writes in as few chip select windows as possible.
+ * Writes keep their order relative to the reads, reads between two writes may be reordered by address.
+ * The bus is owned by the calling task during the whole batch.
+ *
+ * @param Copy_pxDevice		Pointer to the device
+ * @param Copy_pxOps		Pointer to the operations array
+ * @param Copy_u8OpsNo		Number of operations, 1 to SPIREG_BATCH_MAX
+ *
+ * @retval Transfer status, a value of @ref SPI_Status or SPIREG_STATUS_INVALID
+ */
+uint8_t SPIREG_u8Batch(const SPIREG_Device_t* Copy_pxDevice, const SPIREG_Op_t* Copy_pxOps, uint8_t Copy_u8OpsNo)
+{
+	uint8_t Loc_u8Status = SPI_STATUS_OK;
+	uint8_t Loc_u8Index;
+
+	if((Copy_pxDevice == nullptr) || (Copy_pxOps == nullptr) || (Copy_u8OpsNo == 0U) || (Copy_u8OpsNo > SPIREG_BATCH_MAX))
+	{
+		return SPIREG_STATUS_INVALID;
+	}
+
+	for(Loc_u8Index = 0U; Loc_u8Index < Copy_u8OpsNo; Loc_u8Index++)
+	{
+		if((Copy_pxOps[Loc_u8Index].pu8Data == nullptr) || (Copy_pxOps[Loc_u8Index].u8Length == 0U) ||
+		   (Copy_pxOps[Loc_u8Index].u8Length > SPIREG_BURST_MAX) || (Copy_pxOps[Loc_u8Index].u8Access > SPIREG_WRITE))
+		{
+			return SPIREG_STATUS_INVALID;
+		}
+	}
+
+	if(SPI_boolAcquire(Copy_pxDevice -> u8SPIx, Copy_pxDevice -> u32Timeout) == false)
+	{
+		return SPI_STATUS_BUSY;
+	}
+
+	Loc_u8Index = 0U;
+	while((Loc_u8Index < Copy_u8OpsNo) && (Loc_u8Status == SPI_STATUS_OK))
+	{
+		/* Run of consecutive operations of the same access */
+		uint8_t Loc_u8End = Loc_u8Index + 1U;
+
+		while((Loc_u8End < Copy_u8OpsNo) && (Copy_pxOps[Loc_u8End].u8Access == Copy_pxOps[Loc_u8Index].u8Access))
+		{
+			Loc_u8End++;
+		}
+
+		if(Copy_pxOps[Loc_u8Index].u8Access == SPIREG_READ)
+		{
+			Loc_u8Status = SPIREG_u8ReadRun(Copy_pxDevice, &Copy_pxOps[Loc_u8Index], Loc_u8End - Loc_u8Index);
+		}
+		else
+		{
+			Loc_u8Status = SPIREG_u8WriteRun(Copy_pxDevice, &Copy_pxOps[Loc_u8Index], Loc_u8End - Loc_u8Index);
+		}
+
+		Loc_u8Index = Loc_u8End;
+	}
+
+	SPI_vRelease(Copy_pxDevice -> u8SPIx);
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn uint8_t SPIREG_u8Read(const SPIREG_Device_t*, uint8_t, uint8_t*, uint8_t)
+ * @brief Read consecutive registers in one burst
+ *
+ * @param Copy_pxDevice		Pointer to the device
+ * @param Copy_u8Address	First register address
+ * @param Copy_pu8Data		Pointer to the reception buffer
+ * @param Copy_u8Length		Registers to read, 1 to SPIREG_BURST_MAX
+ *
+ * @retval Transfer status, a value of @ref SPI_Status or SPIREG_STATUS_INVALID
+ */
+uint8_t SPIREG_u8Read(const SPIREG_Device_t* Copy_pxDevice, uint8_t Copy_u8Address, uint8_t* Copy_pu8Data, uint8_t Copy_u8Length)
+{
+	SPIREG_Op_t Loc_xOp = {Copy_u8Address, SPIREG_READ, Copy_u8Length, Copy_pu8Data};
+
+	return SPIREG_u8Batch(Copy_pxDevice, &Loc_xOp, 1U);
+}
+
+/**
+ * @fn uint8_t SPIREG_u8Write(const SPIREG_Device_t*, uint8_t, uint8_t*, uint8_t)
+ * @brief Write consecutive registers in one burst
+ *
+ * @param Copy_pxDevice		Pointer to the device
+ * @param Copy_u8Address	First register address
+ * @param Copy_pu8Data		Pointer to the transmission buffer
+ * @param Copy_u8Length		Registers to write, 1 to SPIREG_BURST_MAX
+ *
+ * @retval Transfer status, a value of @ref SPI_Status or SPIREG_STATUS_INVALID
+ */
+uint8_t SPIREG_u8Write(const SPIREG_Device_t* Copy_pxDevice, uint8_t Copy_u8Address, uint8_t* Copy_pu8Data, uint8_t Copy_u8Length)
+{
+	SPIREG_Op_t Loc_xOp = {Copy_u8Address, SPIREG_WRITE, Copy_u8Length, Copy_pu8Data};
+
+	return SPIREG_u8Batch(Copy_pxDevice, &Loc_xOp, 1U);
+}
@@ -0,0 +1,16 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+#ifndef SPIREG_PRIVATE_H
+#define SPIREG_PRIVATE_H
+
+#define SPIREG_DUMMY_BYTE		0xFFU
+
+static uint8_t SPIREG_u8Transfer(const SPIREG_Device_t* Copy_pxDevice, uint8_t* Copy_pu8Frame, uint8_t Copy_u8Length);
+static uint8_t SPIREG_u8ReadRun(const SPIREG_Device_t* Copy_pxDevice, const SPIREG_Op_t* Copy_pxOps, uint8_t Copy_u8OpsNo);
+static uint8_t SPIREG_u8WriteRun(const SPIREG_Device_t* Copy_pxDevice, const SPIREG_Op_t* Copy_pxOps, uint8_t Copy_u8OpsNo);
+
+#endif
@@ -104,6 +104,7 @@
 #define SPI_CLOCK_RATE_FREQ_DIVID_BY_64         5U
 #define SPI_CLOCK_RATE_FREQ_DIVID_BY_128 		6U
 #define SPI_CLOCK_RATE_FREQ_DIVID_BY_256 		7U
+#define SPI_CLOCK_RATE_INVALID					0xFFU
 /**
   * @}
   */
@@ -172,6 +173,158 @@
 /**
   * @}
   */
+
+/** @defgroup SPI_Process SPI Process
+  * @{
+  */
+#define SPI_PROCESS_TX_RX						0U
+#define SPI_PROCESS_RX							1U
+#define SPI_PROCESS_TX							2U
+/**
+  * @}
+  */
+
+/** @defgroup SPI_Transfer_Mode SPI Transfer Mode
+  * @{
+  */
+#define SPI_TRANSFER_POLLING					0U
+#define SPI_TRANSFER_INTERRUPT					1U
+/**
+  * @}
+  */
+
+/** @defgroup SPI_Status SPI Status
+  * @{
+  */
+#define SPI_STATUS_OK							0U
+#define SPI_STATUS_TIMEOUT						1U
+#define SPI_STATUS_BUSY							2U
+#define SPI_STATUS_INVALID						3U
+#define SPI_STATUS_OVERRUN						4U		/* Slave reception lost data, the master sent faster than it was read	*/
+/**
+  * @}
+  */
+
+/** @defgroup SPI_Status_Configuration SPI Status Configuration, can be overridden from the build command line
+  * @{
+  */
+#ifndef SPI_STATUS_SLOTS
+#define SPI_STATUS_SLOTS						8U		/* (task, instance) pairs whose last transfer status is kept	*/
+#endif
+/**
+  * @}
+  */
+
+/** @defgroup SPI_Stream_Half SPI Stream Half
+  * @{
+  */
+#define SPI_STREAM_HALF_FIRST					0U
+#define SPI_STREAM_HALF_SECOND					1U
+/**
+  * @}
+  */
+
+/** @defgroup SPI_Stripe_Lanes SPI Stripe Lanes
+  * @{
+  */
+#define SPI_STRIPE_MAX_LANES					3U
+/**
+  * @}
+  */
+
+/** @defgroup SPI_Trace_Operation SPI Trace Operation
+  * @{
+  */
+#define SPI_TRACE_OP_TX							0U
+#define SPI_TRACE_OP_RX							1U
+#define SPI_TRACE_OP_TX_RX						2U
+/**
+  * @}
+  */
+
+/** @defgroup SPI_Trace_Configuration SPI Trace Configuration, can be overridden from the build command line
+  * @{
+  */
+#ifndef SPI_TRACE_ENABLE
+#define SPI_TRACE_ENABLE						0U		/* 1 to record every blocking transfer in a RAM ring		*/
+#endif
+#ifndef SPI_TRACE_DEPTH
+#define SPI_TRACE_DEPTH							64U		/* Number of records kept in the ring						*/
+#endif
+#ifndef SPI_TRACE_DATA_BYTES
+#define SPI_TRACE_DATA_BYTES					0U		/* Payload bytes captured per record, 0 disables capture	*/
+#endif
+#define SPI_TRACE_MAGIC							0x54495053U		/* "SPIT" in little endian memory				*/
+#define SPI_TRACE_VERSION						2U
+#define SPI_TRACE_INFO_COMPLETE					0x80U	/* u8Info bit set once every field of the slot is written	*/
+/**
+  * @}
+  */
+/***********************************************************************************************************/
+/************************************************* TYPES ***************************************************/
+/**
+  * @brief  RTOS port hooks used for bus arbitration and for waiting inside the blocking transfers.
+  *			Every hook may be left nullptr, the driver then falls back to bare-metal behavior.
+  * @note	Task priorities are compared as plain numbers, a higher value means a higher priority.
+  */
+typedef struct
+{
+	void*		(*pfGetCurrentTask)(void);									/*!< Returns a handle identifying the calling task							*/
+	uint8_t		(*pfGetTaskPriority)(void* Copy_pvTask);					/*!< Returns the current priority of the given task							*/
+	void		(*pfSetTaskPriority)(void* Copy_pvTask, uint8_t Copy_u8Priority);	/*!< Raises or restores a task priority (priority inheritance)		*/
+	void		(*pfEnterCritical)(void);									/*!< Disables task switching while the lock state is updated				*/
+	void		(*pfExitCritical)(void);									/*!< Enables task switching again											*/
+	void		(*pfYield)(void);											/*!< Gives the CPU to another ready task of the same priority				*/
+	void		(*pfSleepUs)(uint32_t Copy_u32Us);							/*!< Blocks the calling task, lets lower priority tasks run					*/
+	uint32_t	u32YieldThresholdUs;										/*!< Time without bus progress after which a blocking transfer sleeps/yields	*/
+}SPI_Port_t;
+
+/**
+  * @brief  Striped bus, one logical buffer split across several SPI instances sharing the same configuration.
+  *			Logical elements are dealt to the lanes in units of u16StripeUnit elements: the 1st unit goes to
+  *			au8Lanes[0], the 2nd to au8Lanes[1] and so on, wrapping back to au8Lanes[0].
+  */
+typedef struct
+{
+	uint8_t		au8Lanes[SPI_STRIPE_MAX_LANES];		/*!< Lane instances, values of @ref SPIx						*/
+	uint8_t		u8LanesNo;							/*!< Number of used lanes										*/
+	uint16_t	u16StripeUnit;						/*!< Consecutive elements sent on a lane before the next one	*/
+	bool		boolDataSize;						/*!< A value of @ref SPI_Data_Size								*/
+	void		(*pfCpltCallBack)(void);			/*!< Called once all the lanes completed a transfer, may be nullptr	*/
+}SPI_Stripe_t;
+
+/**
+  * @brief  Header of the trace ring, followed in memory by SPI_TRACE_DEPTH slots of u8RecordSize bytes.
+  *			Every slot starts with a SPI_TraceRecord_t followed by the captured payload.
+  *			A slot is claimed before its transfer runs, until SPI_TRACE_INFO_COMPLETE is set in its
+  *			u8Info the other fields may still belong to an older transfer.
+  *			All fields are little endian.
+  */
+typedef struct
+{
+	uint32_t	u32Magic;				/*!< SPI_TRACE_MAGIC														*/
+	uint8_t		u8Version;				/*!< SPI_TRACE_VERSION														*/
+	uint8_t		u8RecordSize;			/*!< Size of one slot in bytes												*/
+	uint8_t		u8DataBytes;			/*!< Payload bytes captured per slot, TX / RX records use the 1st half for TX	*/
+	uint8_t		u8Reserved;
+	uint16_t	u16Depth;				/*!< Number of slots														*/
+	uint16_t	u16Reserved;
+	uint32_t	u32Count;				/*!< Records written since the last clear, next slot is u32Count % u16Depth	*/
+}SPI_TraceHeader_t;
+
+/**
+  * @brief  One traced transfer
+  */
+typedef struct
+{
+	uint32_t	u32StartUs;				/*!< micros() when the transfer started after the bus lock was taken, when the wait for the lock started for BUSY records	*/
+	uint32_t	u32EndUs;				/*!< micros() when the transfer ended										*/
+	uint16_t	u16CR1;					/*!< CR1 configuration word during the transfer								*/
+	uint16_t	u16ElementsNo;			/*!< Requested amount of data elements										*/
+	uint16_t	u16Transferred;			/*!< Data elements actually transferred										*/
+	uint8_t		u8Info;					/*!< Bits 0..1: @ref SPIx, bits 2..3: @ref SPI_Trace_Operation, bit 7: SPI_TRACE_INFO_COMPLETE	*/
+	uint8_t		u8Status;				/*!< A value of @ref SPI_Status												*/
+}SPI_TraceRecord_t;
 /***********************************************************************************************************/
 /************************************************* PROTOTYPES **********************************************/
 void SPI_vInit(uint8_t Copy_u8SPIx, bool Copy_boolMode, bool Copy_boolDataSize, bool Copy_boolCLKPolarity,
@@ -186,5 +339,26 @@ void SPI_ENABLE_IT(uint8_t Copy_u8SPIx, uint8_t Copy_u8Interrupt);
 void SPI_DISABLE_IT(uint8_t Copy_u8SPIx, uint8_t Copy_u8Interrupt);
 void SPI_SetTxCallback(uint8_t Copy_u8SPIx, void(*Copy_pfCallBackFunc)(void));
 void SPI_SetRxCallback(uint8_t Copy_u8SPIx, void(*Copy_pfCallBackFunc)(void));
+uint8_t SPI_u8SelectPrescaler(uint32_t Copy_u32PclkHz, uint32_t Copy_u32TargetHz, uint8_t Copy_u8Process, bool Copy_boolTransferMode,
+		bool Copy_boolMode, bool Copy_boolDataSize);
+uint32_t SPI_u32GetClockHz(uint32_t Copy_u32PclkHz, uint8_t Copy_u8BaudRatePrescaler);
+uint32_t SPI_u32PredictTransferUs(uint32_t Copy_u32PclkHz, uint8_t Copy_u8BaudRatePrescaler, uint16_t Copy_u16ElementsNo, bool Copy_boolDataSize,
+		uint32_t Copy_u32LoopCycles);
+void SPI_vSetPort(const SPI_Port_t* Copy_pxPort);
+bool SPI_boolAcquire(uint8_t Copy_u8SPIx, uint32_t Copy_u32Timeout);
+void SPI_vRelease(uint8_t Copy_u8SPIx);
+uint8_t SPI_u8GetLastStatus(uint8_t Copy_u8SPIx);
+bool SPI_boolStreamStart(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Buffer, uint16_t Copy_u16ElementsNo, bool Copy_boolDataSize,
+		void(*Copy_pfHalfCpltCallBack)(void), void(*Copy_pfCpltCallBack)(void));
+void SPI_vStreamSubmit(uint8_t Copy_u8SPIx, uint8_t Copy_u8Half);
+void SPI_vStreamStop(uint8_t Copy_u8SPIx);
+uint32_t SPI_u32StreamGetUnderruns(uint8_t Copy_u8SPIx);
+bool SPI_boolStripeInit(SPI_Stripe_t* Copy_pxStripe, const uint8_t* Copy_pu8Lanes, uint8_t Copy_u8LanesNo, uint16_t Copy_u16StripeUnit,
+		bool Copy_boolMode, bool Copy_boolDataSize, bool Copy_boolCLKPolarity, bool Copy_boolCLKPhase, bool Copy_boolSSM, bool Copy_boolSSI,
+		bool Copy_boolSSOE, uint8_t Copy_u8BaudRatePrescaler, bool Copy_boolFirstBit, void(*Copy_pfCpltCallBack)(void));
+uint8_t SPI_u8StripeTransmitReceive(const SPI_Stripe_t* Copy_pxStripe, uint8_t *Copy_pu8TxData, uint8_t *Copy_pu8RxData,
+		uint16_t Copy_u16ElementsNo, uint32_t Copy_u32Timeout);
+const void* SPI_pvGetTrace(uint32_t* Copy_pu32Size);
+void SPI_vClearTrace(void);
 /***********************************************************************************************************/
 #endif
@@ -5,6 +5,7 @@
  ***********************************************************************************/
 
 #include <stdint.h>
+#include <atomic>
 #include "BIT_MATH.h"
 #include "../06-STK/STK_module.h"
 #include "SPI_interface.h"
@@ -13,6 +14,56 @@
 /* static global array of function pointers to use in the set call back */
 static void(*Glo_pfCallBacks[6])(void) = {0};
 
+/* bare-metal port, no task switching, every hook left empty */
+static const SPI_Port_t Glo_xBareMetalPort = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0U};
+
+/* static global pointer to the RTOS port hooks registered by SPI_vSetPort */
+static const SPI_Port_t* Glo_pxPort = &Glo_xBareMetalPort;
+
+/* static global array of bus locks, one per SPI instance */
+static SPI_Lock_t Glo_xLocks[SPI_INSTANCES_NO] = {};
+
+/* static global array of the priority inheritance state of the tasks holding bus locks,
+ * kept per task because a task may hold several locks (striped bus) */
+static SPI_Holder_t Glo_xHolders[SPI_INSTANCES_NO] = {};
+
+/* static global array of the last transfer status of each task on each SPI instance, a task that
+ * fails to take the bus must not overwrite the status of the owner. Slots are reused in turn when full */
+static SPI_Status_t Glo_xStatus[SPI_STATUS_SLOTS] = {};
+static uint8_t Glo_u8StatusNext = 0U;
+
+/* static global array of the continuous transmit streams, one per SPI instance */
+static SPI_Stream_t Glo_xStreams[SPI_INSTANCES_NO] = {};
+
+#if SPI_TRACE_ENABLE
+static_assert(sizeof(SPI_TraceSlot_t) <= 0xFFU, "SPI_TRACE_DATA_BYTES too large for the trace slot size field");
+
+/* static global trace ring, read by SPI_pvGetTrace or dumped by a debugger */
+static SPI_Trace_t Glo_xTrace =
+{
+	{SPI_TRACE_MAGIC, SPI_TRACE_VERSION, (uint8_t)sizeof(SPI_TraceSlot_t), SPI_TRACE_DATA_BYTES, 0U, SPI_TRACE_DEPTH, 0U, 0U},
+	{}
+};
+#endif
+
+/* static global table of the fastest prescaler allowed in 2 lines full duplex (see the table in SPI_interface.h),
+ * indexed by [@ref SPI_Data_Size][@ref SPI_Process][@ref SPI_Transfer_Mode][@ref SPI_Mode] */
+static const uint8_t Glo_u8MinPrescaler[2][3][2][2] =
+{
+	/* SPI_DATASIZE_8BIT */
+	{
+		/* TX / RX */	{ {SPI_CLOCK_RATE_FREQ_DIVID_BY_2, SPI_CLOCK_RATE_FREQ_DIVID_BY_2}, {SPI_CLOCK_RATE_FREQ_DIVID_BY_8, SPI_CLOCK_RATE_FREQ_DIVID_BY_4} },
+		/* RX */		{ {SPI_CLOCK_RATE_FREQ_DIVID_BY_2, SPI_CLOCK_RATE_FREQ_DIVID_BY_2}, {SPI_CLOCK_RATE_FREQ_DIVID_BY_8, SPI_CLOCK_RATE_FREQ_DIVID_BY_8} },
+		/* TX */		{ {SPI_CLOCK_RATE_FREQ_DIVID_BY_4, SPI_CLOCK_RATE_FREQ_DIVID_BY_2}, {SPI_CLOCK_RATE_FREQ_DIVID_BY_4, SPI_CLOCK_RATE_FREQ_DIVID_BY_2} },
+	},
+	/* SPI_DATASIZE_16BIT */
+	{
+		/* TX / RX */	{ {SPI_CLOCK_RATE_FREQ_DIVID_BY_2, SPI_CLOCK_RATE_FREQ_DIVID_BY_2}, {SPI_CLOCK_RATE_FREQ_DIVID_BY_4, SPI_CLOCK_RATE_FREQ_DIVID_BY_4} },
+		/* RX */		{ {SPI_CLOCK_RATE_FREQ_DIVID_BY_2, SPI_CLOCK_RATE_FREQ_DIVID_BY_2}, {SPI_CLOCK_RATE_FREQ_DIVID_BY_4, SPI_CLOCK_RATE_FREQ_DIVID_BY_4} },
+		/* TX */		{ {SPI_CLOCK_RATE_FREQ_DIVID_BY_2, SPI_CLOCK_RATE_FREQ_DIVID_BY_2}, {SPI_CLOCK_RATE_FREQ_DIVID_BY_2, SPI_CLOCK_RATE_FREQ_DIVID_BY_2} },
+	},
+};
+
 /**
  * @fn SPI_t SPI_pxPtrSelect*(uint8_t)
  * @brief Select the peripheral handler
@@ -37,6 +88,307 @@ static SPI_t* SPI_pxPtrSelect(uint8_t Copy_u8SPIx)
 	return Loc_pxSPI_t;
 }
 
+/**
+ * @fn void* SPI_pvCurrentTask(void)
+ * @brief Identify the calling task through the port hooks
+ *
+ * @retval Handle of the calling task, a fixed handle when no scheduler is used
+ */
+static void* SPI_pvCurrentTask(void)
+{
+	void* Loc_pvTask = (void*)&Glo_xLocks;
+
+	if(Glo_pxPort -> pfGetCurrentTask != nullptr)
+	{
+		Loc_pvTask = Glo_pxPort -> pfGetCurrentTask();
+	}
+
+	return Loc_pvTask;
+}
+
+/**
+ * @fn SPI_Holder_t* SPI_pxHolderFind(void*)
+ * @brief Find the priority inheritance state of a task holding bus locks, called inside a critical section
+ *
+ * @param Copy_pvTask	Handle of the task, nullptr finds a free entry
+ *
+ * @retval Pointer to the entry, nullptr if the task holds no bus lock
+ */
+static SPI_Holder_t* SPI_pxHolderFind(void* Copy_pvTask)
+{
+	SPI_Holder_t* Loc_pxHolder = nullptr;
+	uint8_t Loc_u8Index;
+
+	for(Loc_u8Index = 0U; Loc_u8Index < SPI_INSTANCES_NO; Loc_u8Index++)
+	{
+		if(Glo_xHolders[Loc_u8Index].pvTask == Copy_pvTask)
+		{
+			Loc_pxHolder = &Glo_xHolders[Loc_u8Index];
+			break;
+		}
+	}
+
+	return Loc_pxHolder;
+}
+
+/**
+ * @fn void SPI_vSetStatus(uint8_t, uint8_t)
+ * @brief Store the outcome of a blocking transfer for the calling task
+ *
+ * @param Copy_u8SPIx		Specifies which SPI handler was used
+ * @param Copy_u8Status		Transfer status, a value of @ref SPI_Status
+ *
+ * @retval None
+ */
+static void SPI_vSetStatus(uint8_t Copy_u8SPIx, uint8_t Copy_u8Status)
+{
+	void* Loc_pvSelf = SPI_pvCurrentTask();
+	SPI_Status_t* Loc_pxSlot = nullptr;
+	uint8_t Loc_u8Index;
+
+	SPI_vEnterCritical();
+
+	for(Loc_u8Index = 0U; (Loc_u8Index < SPI_STATUS_SLOTS) && (Loc_pxSlot == nullptr); Loc_u8Index++)
+	{
+		if((Glo_xStatus[Loc_u8Index].pvTask == Loc_pvSelf) && (Glo_xStatus[Loc_u8Index].u8SPIx == Copy_u8SPIx))
+		{
+			Loc_pxSlot = &Glo_xStatus[Loc_u8Index];
+		}
+	}
+	for(Loc_u8Index = 0U; (Loc_u8Index < SPI_STATUS_SLOTS) && (Loc_pxSlot == nullptr); Loc_u8Index++)
+	{
+		if(Glo_xStatus[Loc_u8Index].pvTask == nullptr)
+		{
+			Loc_pxSlot = &Glo_xStatus[Loc_u8Index];
+		}
+	}
+	if(Loc_pxSlot == nullptr)
+	{
+		Loc_pxSlot = &Glo_xStatus[Glo_u8StatusNext];
+		Glo_u8StatusNext = (uint8_t)((Glo_u8StatusNext + 1U) % SPI_STATUS_SLOTS);
+	}
+
+	Loc_pxSlot -> pvTask	= Loc_pvSelf;
+	Loc_pxSlot -> u8SPIx	= Copy_u8SPIx;
+	Loc_pxSlot -> u8Status	= Copy_u8Status;
+
+	SPI_vExitCritical();
+}
+
+/**
+ * @fn void SPI_vEnterCritical(void)
+ * @brief Protect the bus lock state against task switching
+ *
+ * @retval None
+ */
+static void SPI_vEnterCritical(void)
+{
+	if(Glo_pxPort -> pfEnterCritical != nullptr)
+	{
+		Glo_pxPort -> pfEnterCritical();
+	}
+}
+
+/**
+ * @fn void SPI_vExitCritical(void)
+ * @brief End of the protection started by SPI_vEnterCritical
+ *
+ * @retval None
+ */
+static void SPI_vExitCritical(void)
+{
+	if(Glo_pxPort -> pfExitCritical != nullptr)
+	{
+		Glo_pxPort -> pfExitCritical();
+	}
+}
+
+/**
+ * @fn void SPI_vWaitInit(SPI_Wait_t*, uint16_t, bool)
+ * @brief Init the timeout management of a blocking transfer
+ *
+ * @param Copy_pxWait			Pointer to the wait state of the transfer
+ * @param Copy_u16Remaining		Amount of data elements left to transfer
+ * @param Copy_boolMayYield		true when this driver is the master of the transfer, a slave never sleeps
+ * since the external master keeps clocking and the 2 frames of the hardware buffer would overrun
+ *
+ * @retval None
+ */
+static void SPI_vWaitInit(SPI_Wait_t* Copy_pxWait, uint16_t Copy_u16Remaining, bool Copy_boolMayYield)
+{
+	Copy_pxWait -> u64TickStart  = micros();
+	Copy_pxWait -> u64StallStart = Copy_pxWait -> u64TickStart;
+	Copy_pxWait -> u16Remaining  = Copy_u16Remaining;
+	Copy_pxWait -> boolMayYield  = Copy_boolMayYield;
+}
+
+/**
+ * @fn bool SPI_boolWaitTimeout(SPI_Wait_t*, uint16_t, uint32_t)
+ * @brief Timeout management of a blocking transfer, when the driver is the master and the bus made
+ * no progress for longer than the port yield threshold the CPU is given to the other tasks instead of spinning
+ *
+ * @param Copy_pxWait			Pointer to the wait state of the transfer
+ * @param Copy_u16Remaining		Amount of data elements left to transfer
+ * @param Copy_u32Timeout		Timeout duration
+ *
+ * @retval true if the timeout elapsed
+ */
+static bool SPI_boolWaitTimeout(SPI_Wait_t* Copy_pxWait, uint16_t Copy_u16Remaining, uint32_t Copy_u32Timeout)
+{
+	uint64_t Loc_u64Now = micros();
+	bool Loc_boolTimeout = ((Loc_u64Now - Copy_pxWait -> u64TickStart) >= Copy_u32Timeout);
+
+	if(Loc_boolTimeout == false)
+	{
+		if(Copy_u16Remaining != Copy_pxWait -> u16Remaining)
+		{
+			Copy_pxWait -> u16Remaining  = Copy_u16Remaining;
+			Copy_pxWait -> u64StallStart = Loc_u64Now;
+		}
+		else if((Copy_pxWait -> boolMayYield == true) && ((Loc_u64Now - Copy_pxWait -> u64StallStart) >= Glo_pxPort -> u32YieldThresholdUs))
+		{
+			if(Glo_pxPort -> pfSleepUs != nullptr)
+			{
+				Glo_pxPort -> pfSleepUs(Glo_pxPort -> u32YieldThresholdUs);
+			}
+			else if(Glo_pxPort -> pfYield != nullptr)
+			{
+				Glo_pxPort -> pfYield();
+			}
+			else
+			{
+
+			}
+		}
+		else
+		{
+
+		}
+	}
+
+	return Loc_boolTimeout;
+}
+
+/**
+ * @fn void* SPI_pvTraceStart(uint8_t, uint8_t, uint16_t, const uint8_t*)
+ * @brief Claim a trace slot for a blocking transfer and capture the data to send before the transfer
+ * overwrites it (in place transfers), compiled out when SPI_TRACE_ENABLE is 0
+ *
+ * @param Copy_u8SPIx			Specifies which SPI handler is used
+ * @param Copy_u8Operation		This parameter can be a value of @ref SPI_Trace_Operation
+ * @param Copy_u16ElementsNo	Requested amount of data elements
+ * @param Copy_pu8TxData		Start of the transmission data buffer, nullptr if not used
+ *
+ * @retval Slot to pass to SPI_vTraceRecord, nullptr when the trace is disabled
+ */
+static void* SPI_pvTraceStart(uint8_t Copy_u8SPIx, uint8_t Copy_u8Operation, uint16_t Copy_u16ElementsNo, const uint8_t* Copy_pu8TxData)
+{
+	void* Loc_pvSlot = nullptr;
+
+#if SPI_TRACE_ENABLE
+	SPI_t* Loc_pxSPI_t = SPI_pxPtrSelect(Copy_u8SPIx);
+
+	/* Claim a slot, the ring is shared by all the instances */
+	SPI_vEnterCritical();
+	SPI_TraceSlot_t* Loc_pxSlot = &Glo_xTrace.axSlots[Glo_xTrace.xHeader.u32Count % SPI_TRACE_DEPTH];
+	Glo_xTrace.xHeader.u32Count++;
+	SPI_vExitCritical();
+
+	/* Mark the slot incomplete before its older fields are overwritten, a dump may be taken at any time */
+	Loc_pxSlot -> xRecord.u8Info			= (uint8_t)(Copy_u8SPIx | (Copy_u8Operation << 2));
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+
+	/* Start of the attempt, replaced by the transfer start once the bus lock is taken */
+	Loc_pxSlot -> xRecord.u32StartUs		= (uint32_t)micros();
+	Loc_pxSlot -> xRecord.u16ElementsNo		= Copy_u16ElementsNo;
+
+#if SPI_TRACE_DATA_BYTES > 0U
+	uint32_t Loc_u32Bytes = (uint32_t)Copy_u16ElementsNo << Loc_pxSPI_t -> CR1.BitAccess.DFF;
+	uint32_t Loc_u32TxBytes = (Copy_u8Operation == SPI_TRACE_OP_TX_RX) ? (SPI_TRACE_DATA_BYTES / 2U) : SPI_TRACE_DATA_BYTES;
+	uint32_t Loc_u32Index;
+
+	if(Copy_pu8TxData != nullptr)
+	{
+		for(Loc_u32Index = 0U; (Loc_u32Index < Loc_u32TxBytes) && (Loc_u32Index < Loc_u32Bytes); Loc_u32Index++)
+		{
+			Loc_pxSlot -> au8Data[Loc_u32Index] = Copy_pu8TxData[Loc_u32Index];
+		}
+	}
+#else
+	(void)Loc_pxSPI_t;
+	(void)Copy_pu8TxData;
+#endif
+
+	Loc_pvSlot = Loc_pxSlot;
+#else
+	(void)Copy_u8SPIx;
+	(void)Copy_u8Operation;
+	(void)Copy_u16ElementsNo;
+	(void)Copy_pu8TxData;
+#endif
+
+	return Loc_pvSlot;
+}
+
+/**
+ * @fn void SPI_vTraceRecord(void*, uint8_t, const SPI_Wait_t*, uint16_t, const uint8_t*)
+ * @brief Complete the trace slot of a finished blocking transfer, compiled out when SPI_TRACE_ENABLE is 0
+ *
+ * @param Copy_pvSlot			Slot returned by SPI_pvTraceStart
+ * @param Copy_u8SPIx			Specifies which SPI handler was used
+ * @param Copy_pxWait			Wait state of the transfer, nullptr if the bus lock was not taken
+ * @param Copy_u16Remaining		Data elements left when the transfer ended
+ * @param Copy_pu8RxData		Start of the reception data buffer, nullptr if not used
+ *
+ * @retval None
+ */
+static void SPI_vTraceRecord(void* Copy_pvSlot, uint8_t Copy_u8SPIx, const SPI_Wait_t* Copy_pxWait, uint16_t Copy_u16Remaining,
+		const uint8_t* Copy_pu8RxData)
+{
+#if SPI_TRACE_ENABLE
+	SPI_t* Loc_pxSPI_t = SPI_pxPtrSelect(Copy_u8SPIx);
+	SPI_TraceSlot_t* Loc_pxSlot = (SPI_TraceSlot_t*)Copy_pvSlot;
+	uint16_t Loc_u16Transferred = Loc_pxSlot -> xRecord.u16ElementsNo - Copy_u16Remaining;
+
+	if(Copy_pxWait != nullptr)
+	{
+		Loc_pxSlot -> xRecord.u32StartUs	= (uint32_t)Copy_pxWait -> u64TickStart;
+	}
+	Loc_pxSlot -> xRecord.u32EndUs			= (uint32_t)micros();
+	Loc_pxSlot -> xRecord.u16CR1			= (uint16_t)Loc_pxSPI_t -> CR1.RegisterAccess;
+	Loc_pxSlot -> xRecord.u16Transferred	= Loc_u16Transferred;
+	Loc_pxSlot -> xRecord.u8Status			= SPI_u8GetLastStatus(Copy_u8SPIx);
+
+#if SPI_TRACE_DATA_BYTES > 0U
+	uint32_t Loc_u32Bytes = (uint32_t)Loc_u16Transferred << Loc_pxSPI_t -> CR1.BitAccess.DFF;
+	uint32_t Loc_u32Index;
+
+	if(Copy_pu8RxData != nullptr)
+	{
+		/* TX / RX records keep the received data in the 2nd half of the payload */
+		uint32_t Loc_u32Offset = ((Loc_pxSlot -> xRecord.u8Info >> 2) == SPI_TRACE_OP_TX_RX) ? (SPI_TRACE_DATA_BYTES / 2U) : 0U;
+
+		for(Loc_u32Index = 0U; ((Loc_u32Offset + Loc_u32Index) < SPI_TRACE_DATA_BYTES) && (Loc_u32Index < Loc_u32Bytes); Loc_u32Index++)
+		{
+			Loc_pxSlot -> au8Data[Loc_u32Offset + Loc_u32Index] = Copy_pu8RxData[Loc_u32Index];
+		}
+	}
+#else
+	(void)Copy_pu8RxData;
+#endif
+
+	/* Every field is written, the slot can be decoded */
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	Loc_pxSlot -> xRecord.u8Info			|= SPI_TRACE_INFO_COMPLETE;
+#else
+	(void)Copy_pvSlot;
+	(void)Copy_u8SPIx;
+	(void)Copy_pxWait;
+	(void)Copy_u16Remaining;
+	(void)Copy_pu8RxData;
+#endif
+}
+
 /**
  * @fn void SPI1_vInit(uint8_t, bool, bool, bool, bool, bool, uint8_t, bool)
  *
@@ -146,9 +498,9 @@ void SPI_vDisable(uint8_t Copy_u8SPIx)
  * @param Copy_boolDataSize		Specifies the SPI data size
  * This parameter can be a value of @ref SPI_Data_Size
  *
- * @param Copy_u32Timeout		Timeout Timeout duration
+ * @param Copy_u32Timeout		Timeout Timeout duration, also bounds the wait for the bus lock
  *
- * @retval None
+ * @retval None, the outcome can be read by SPI_u8GetLastStatus
  */
 void SPI_vTransmit(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16ElementsNo, bool Copy_boolDataSize, uint32_t Copy_u32Timeout)
 {
@@ -156,8 +508,19 @@ void SPI_vTransmit(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16
 
 	if((Loc_pxSPI_t != nullptr) && (Copy_pu8Data != nullptr) && (Copy_u16ElementsNo != 0U))
 	{
+		void* Loc_pvTrace = SPI_pvTraceStart(Copy_u8SPIx, SPI_TRACE_OP_TX, Copy_u16ElementsNo, Copy_pu8Data);
+
+		/* A continuous transmission owns the data register, even for the task that started it */
+		if((Glo_xStreams[SPI_INDEX(Copy_u8SPIx)].boolActive == true) || (SPI_boolAcquire(Copy_u8SPIx, Copy_u32Timeout) == false))
+		{
+			SPI_vSetStatus(Copy_u8SPIx, SPI_STATUS_BUSY);
+			SPI_vTraceRecord(Loc_pvTrace, Copy_u8SPIx, nullptr, Copy_u16ElementsNo, nullptr);
+			return;
+		}
+
 		/* Init tickstart for timeout management*/
-		uint64_t Loc_u64tickstart = micros();
+		SPI_Wait_t Loc_xWait;
+		SPI_vWaitInit(&Loc_xWait, Copy_u16ElementsNo, (Loc_pxSPI_t -> CR1.BitAccess.MSTR == SPI_MODE_MASTER));
 
 		/* Transmit data in 16 Bit mode */
 		if(Copy_boolDataSize == SPI_DATASIZE_16BIT)
@@ -174,7 +537,7 @@ void SPI_vTransmit(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16
 				else
 				{
 					/* Timeout management */
-					if ((micros() - Loc_u64tickstart) >=  Copy_u32Timeout)
+					if (SPI_boolWaitTimeout(&Loc_xWait, Copy_u16ElementsNo, Copy_u32Timeout))
 					{
 						break;
 					}
@@ -196,19 +559,27 @@ void SPI_vTransmit(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16
 				else
 				{
 					/* Timeout management */
-					if ((micros() - Loc_u64tickstart) >=  Copy_u32Timeout)
+					if (SPI_boolWaitTimeout(&Loc_xWait, Copy_u16ElementsNo, Copy_u32Timeout))
 					{
 						break;
 					}
 				}
 			}
 		}
+
+		SPI_vSetStatus(Copy_u8SPIx, (Copy_u16ElementsNo == 0U) ? SPI_STATUS_OK : SPI_STATUS_TIMEOUT);
+
+		SPI_vTraceRecord(Loc_pvTrace, Copy_u8SPIx, &Loc_xWait, Copy_u16ElementsNo, nullptr);
+
+		SPI_vRelease(Copy_u8SPIx);
 	}
 }
 
 /**
  * @fn void SPI_vReceive(uint8_t, uint16_t*, uint16_t, bool, uint32_t)
  * @brief Receive an amount of data in blocking mode.
+ * In slave mode the CPU is never given away while waiting, and frames lost because the master
+ * sent faster than they were read end the reception with SPI_STATUS_OVERRUN.
  *
  * @param Copy_u8SPIx			Specifies which SPI handler to use
  * This parameter can be a value of @ref SPIx
@@ -219,9 +590,9 @@ void SPI_vTransmit(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16
  * @param Copy_boolDataSize		Specifies the SPI data size
  * This parameter can be a value of @ref SPI_Data_Size
  *
- * @param Copy_u32Timeout		Timeout Timeout duration
+ * @param Copy_u32Timeout		Timeout Timeout duration, also bounds the wait for the bus lock
  *
- * @retval None
+ * @retval None, the outcome can be read by SPI_u8GetLastStatus
  */
 void SPI_vReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16ElementsNo, bool Copy_boolDataSize, uint32_t Copy_u32Timeout)
 {
@@ -232,12 +603,26 @@ void SPI_vReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16E
 		if(Loc_pxSPI_t -> CR1.BitAccess.MSTR == SPI_MODE_MASTER)
 		{
 		    /* Call transmit-receive function to send Dummy data on Tx line and generate clock on CLK line */
-		    return SPI_vTransmitReceive(Copy_u8SPIx, Copy_pu8Data, Copy_pu8Data, Copy_u16ElementsNo, Copy_boolDataSize, 1000000);
+		    return SPI_vTransmitReceive(Copy_u8SPIx, Copy_pu8Data, Copy_pu8Data, Copy_u16ElementsNo, Copy_boolDataSize, Copy_u32Timeout);
 		}
 		else
 		{
+			void* Loc_pvTrace = SPI_pvTraceStart(Copy_u8SPIx, SPI_TRACE_OP_RX, Copy_u16ElementsNo, nullptr);
+
+			/* A continuous transmission owns the data register, even for the task that started it */
+			if((Glo_xStreams[SPI_INDEX(Copy_u8SPIx)].boolActive == true) || (SPI_boolAcquire(Copy_u8SPIx, Copy_u32Timeout) == false))
+			{
+				SPI_vSetStatus(Copy_u8SPIx, SPI_STATUS_BUSY);
+				SPI_vTraceRecord(Loc_pvTrace, Copy_u8SPIx, nullptr, Copy_u16ElementsNo, nullptr);
+				return;
+			}
+
 			/* Init tickstart for timeout management*/
-			uint64_t Loc_u64tickstart = micros();
+			SPI_Wait_t Loc_xWait;
+			SPI_vWaitInit(&Loc_xWait, Copy_u16ElementsNo, false);
+
+			const uint8_t* Loc_pu8RxStart = Copy_pu8Data;
+			bool Loc_boolOverrun = false;
 
 			/* Receive data in 16 Bit mode */
 			if(Copy_boolDataSize == SPI_DATASIZE_16BIT)
@@ -245,8 +630,14 @@ void SPI_vReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16E
 				/* Transfer loop */
 				while (Copy_u16ElementsNo > 0U)
 				{
+					/* Check the OVR flag, the master sent more than the 2 frames the hardware holds */
+					if(Loc_pxSPI_t -> SR.BitAccess.OVR)
+					{
+						Loc_boolOverrun = true;
+						break;
+					}
 					/* Check the RXNE flag */
-					if(Loc_pxSPI_t -> SR.BitAccess.RXNE)
+					else if(Loc_pxSPI_t -> SR.BitAccess.RXNE)
 					{
 						*(uint16_t*)Copy_pu8Data = (uint16_t)Loc_pxSPI_t -> DR;
 						Copy_pu8Data += 2;
@@ -255,7 +646,7 @@ void SPI_vReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16E
 					else
 					{
 						/* Timeout management */
-						if ((micros() - Loc_u64tickstart) >=  Copy_u32Timeout)
+						if (SPI_boolWaitTimeout(&Loc_xWait, Copy_u16ElementsNo, Copy_u32Timeout))
 						{
 							break;
 						}
@@ -268,8 +659,14 @@ void SPI_vReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16E
 				/* Transfer loop */
 				while (Copy_u16ElementsNo > 0U)
 				{
+					/* Check the OVR flag, the master sent more than the 2 frames the hardware holds */
+					if(Loc_pxSPI_t -> SR.BitAccess.OVR)
+					{
+						Loc_boolOverrun = true;
+						break;
+					}
 					/* Check the RXNE flag */
-					if(Loc_pxSPI_t -> SR.BitAccess.RXNE)
+					else if(Loc_pxSPI_t -> SR.BitAccess.RXNE)
 					{
 						*Copy_pu8Data = (uint8_t)Loc_pxSPI_t -> DR;
 						Copy_pu8Data++;
@@ -278,13 +675,29 @@ void SPI_vReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16E
 					else
 					{
 						/* Timeout management */
-						if ((micros() - Loc_u64tickstart) >=  Copy_u32Timeout)
+						if (SPI_boolWaitTimeout(&Loc_xWait, Copy_u16ElementsNo, Copy_u32Timeout))
 						{
 							break;
 						}
 					}
 				}
 			}
+
+			if(Loc_boolOverrun == true)
+			{
+				/* Received frames were lost, clear OVR (read DR then SR) */
+				(void)Loc_pxSPI_t -> DR;
+				(void)Loc_pxSPI_t -> SR.RegisterAccess;
+				SPI_vSetStatus(Copy_u8SPIx, SPI_STATUS_OVERRUN);
+			}
+			else
+			{
+				SPI_vSetStatus(Copy_u8SPIx, (Copy_u16ElementsNo == 0U) ? SPI_STATUS_OK : SPI_STATUS_TIMEOUT);
+			}
+
+			SPI_vTraceRecord(Loc_pvTrace, Copy_u8SPIx, &Loc_xWait, Copy_u16ElementsNo, Loc_pu8RxStart);
+
+			SPI_vRelease(Copy_u8SPIx);
 		}
 	}
 }
@@ -303,9 +716,9 @@ void SPI_vReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Data, uint16_t Copy_u16E
  * @param Copy_boolDataSize				Specifies the SPI data size
  * This parameter can be a value of @ref SPI_Data_Size
  *
- * @param Copy_u32Timeout				Timeout Timeout duration
+ * @param Copy_u32Timeout				Timeout Timeout duration, also bounds the wait for the bus lock
  *
- * @retval None
+ * @retval None, the outcome can be read by SPI_u8GetLastStatus
  */
 void SPI_vTransmitReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8TxData, uint8_t *Copy_pu8RxData ,uint16_t Copy_u16ElementsNo, bool Copy_boolDataSize, uint32_t Copy_u32Timeout)
 {
@@ -313,6 +726,17 @@ void SPI_vTransmitReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8TxData, uint8_t
 
 	if((Loc_pxSPI_t != nullptr) && (Copy_pu8TxData != nullptr) && (Copy_pu8RxData != nullptr) && (Copy_u16ElementsNo != 0U))
 	{
+		/* The data to send is captured first, it is overwritten by in place transfers */
+		void* Loc_pvTrace = SPI_pvTraceStart(Copy_u8SPIx, SPI_TRACE_OP_TX_RX, Copy_u16ElementsNo, Copy_pu8TxData);
+
+		/* A continuous transmission owns the data register, even for the task that started it */
+		if((Glo_xStreams[SPI_INDEX(Copy_u8SPIx)].boolActive == true) || (SPI_boolAcquire(Copy_u8SPIx, Copy_u32Timeout) == false))
+		{
+			SPI_vSetStatus(Copy_u8SPIx, SPI_STATUS_BUSY);
+			SPI_vTraceRecord(Loc_pvTrace, Copy_u8SPIx, nullptr, Copy_u16ElementsNo, nullptr);
+			return;
+		}
+
 		uint16_t Loc_u16TxSize, Loc_u16RxSize;
 
 		Loc_u16TxSize = Loc_u16RxSize = Copy_u16ElementsNo;
@@ -320,7 +744,10 @@ void SPI_vTransmitReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8TxData, uint8_t
 		bool txallowed = true;
 
 		/* Init tickstart for timeout management*/
-		uint64_t Loc_u64tickstart = micros();
+		SPI_Wait_t Loc_xWait;
+		SPI_vWaitInit(&Loc_xWait, Loc_u16RxSize, (Loc_pxSPI_t -> CR1.BitAccess.MSTR == SPI_MODE_MASTER));
+
+		const uint8_t* Loc_pu8RxStart = Copy_pu8RxData;
 
 		/* Transmit and receive data in 16 Bit mode */
 		if(Copy_boolDataSize == SPI_DATASIZE_16BIT)
@@ -348,7 +775,7 @@ void SPI_vTransmitReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8TxData, uint8_t
 				}
 
 				/* Timeout management */
-				if ((micros() - Loc_u64tickstart) >=  Copy_u32Timeout)
+				if (SPI_boolWaitTimeout(&Loc_xWait, Loc_u16RxSize, Copy_u32Timeout))
 				{
 					break;
 				}
@@ -380,95 +807,891 @@ void SPI_vTransmitReceive(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8TxData, uint8_t
 				}
 
 				/* Timeout management */
-				if ((micros() - Loc_u64tickstart) >=  Copy_u32Timeout)
+				if (SPI_boolWaitTimeout(&Loc_xWait, Loc_u16RxSize, Copy_u32Timeout))
 				{
 					break;
 				}
 			}
 		}
+
+		SPI_vSetStatus(Copy_u8SPIx, (Loc_u16RxSize == 0U) ? SPI_STATUS_OK : SPI_STATUS_TIMEOUT);
+
+		SPI_vTraceRecord(Loc_pvTrace, Copy_u8SPIx, &Loc_xWait, Loc_u16RxSize, Loc_pu8RxStart);
+
+		SPI_vRelease(Copy_u8SPIx);
 	}
 }
 
 /**
- * @brief  Enable the specified SPI interrupts.
- * @param  Copy_u8SPIx			Specifies which SPI handler to use
- * This parameter can be a value of @ref SPIx
+ * @fn uint8_t SPI_u8SelectPrescaler(uint32_t, uint32_t, uint8_t, bool, bool, bool)
+ * @brief Select the fastest baud rate prescaler that respects both the device maximum clock
+ * and the limit of the selected transfer mode (2 lines full duplex, see the table in SPI_interface.h)
  *
- * @param  Copy_u8Interrupt 	Specifies the interrupt source to enable.
- * This parameter can be a value of @ref SPI_Interrupt_definition
+ * @param Copy_u32PclkHz				APB clock feeding the SPI peripheral (PCLK2 for SPI1, PCLK1 for SPI2 and SPI3)
+ * @param Copy_u32TargetHz				Maximum SCK frequency supported by the device
  *
- * @retval None
+ * @param Copy_u8Process				Specifies the transfer direction
+ * This parameter can be a value of @ref SPI_Process
+ *
+ * @param Copy_boolTransferMode			Specifies whether the transfer is done by polling or interrupts
+ * This parameter can be a value of @ref SPI_Transfer_Mode
+ *
+ * @param Copy_boolMode					Specifies the SPI operating mode, in slave mode the result is the fastest
+ * clock the master may drive, expressed as a prescaler of the slave PCLK
+ * This parameter can be a value of @ref SPI_Mode
+ *
+ * @param Copy_boolDataSize				Specifies the SPI data size
+ * This parameter can be a value of @ref SPI_Data_Size
+ *
+ * @retval A value of @ref SPI_BaudRate_Prescaler, SPI_CLOCK_RATE_INVALID if no prescaler is slow enough
  */
-void SPI_ENABLE_IT(uint8_t Copy_u8SPIx, uint8_t Copy_u8Interrupt)
+uint8_t SPI_u8SelectPrescaler(uint32_t Copy_u32PclkHz, uint32_t Copy_u32TargetHz, uint8_t Copy_u8Process, bool Copy_boolTransferMode,
+		bool Copy_boolMode, bool Copy_boolDataSize)
 {
-	SPI_t* Loc_pxSPI_t = SPI_pxPtrSelect(Copy_u8SPIx);
+	uint8_t Loc_u8Prescaler = SPI_CLOCK_RATE_INVALID;
 
-	if(Loc_pxSPI_t != nullptr)
+	if((Copy_u32PclkHz != 0U) && (Copy_u8Process <= SPI_PROCESS_TX))
 	{
-		Loc_pxSPI_t->CR2.RegisterAccess |= 1 << Copy_u8Interrupt;
+		uint8_t Loc_u8BR = Glo_u8MinPrescaler[Copy_boolDataSize][Copy_u8Process][Copy_boolTransferMode][Copy_boolMode];
+
+		for(; Loc_u8BR <= SPI_CLOCK_RATE_FREQ_DIVID_BY_256; Loc_u8BR++)
+		{
+			if(SPI_u32GetClockHz(Copy_u32PclkHz, Loc_u8BR) <= Copy_u32TargetHz)
+			{
+				Loc_u8Prescaler = Loc_u8BR;
+				break;
+			}
+		}
 	}
+
+	return Loc_u8Prescaler;
 }
 
 /**
- * @brief  Disable the specified SPI interrupts.
- * @param  Copy_u8SPIx			Specifies which SPI handler to use
- * This parameter can be a value of @ref SPIx
+ * @fn uint32_t SPI_u32GetClockHz(uint32_t, uint8_t)
+ * @brief Compute the SCK frequency generated with a given baud rate prescaler
  *
- * @param  Copy_u8Interrupt 	Specifies the interrupt source to disable.
- * This parameter can be a value of @ref SPI_Interrupt_definition
+ * @param Copy_u32PclkHz				APB clock feeding the SPI peripheral
+ * @param Copy_u8BaudRatePrescaler		This parameter can be a value of @ref SPI_BaudRate_Prescaler
  *
- * @retval None
+ * @retval SCK frequency in Hz
  */
-void SPI_DISABLE_IT(uint8_t Copy_u8SPIx, uint8_t Copy_u8Interrupt)
+uint32_t SPI_u32GetClockHz(uint32_t Copy_u32PclkHz, uint8_t Copy_u8BaudRatePrescaler)
 {
-	SPI_t* Loc_pxSPI_t = SPI_pxPtrSelect(Copy_u8SPIx);
-
-	if(Loc_pxSPI_t != nullptr)
-	{
-		Loc_pxSPI_t->CR2.RegisterAccess &= ~(1 << Copy_u8Interrupt);
-	}
+	return Copy_u32PclkHz >> ((Copy_u8BaudRatePrescaler & 0x07U) + 1U);
 }
 
 /**
- * @fn void SPI_SetTxCallback(uint8_t, void(*)(void))
- * @brief
+ * @fn uint32_t SPI_u32PredictTransferUs(uint32_t, uint8_t, uint16_t, bool, uint32_t)
+ * @brief Predict the duration of a blocking transfer, rounded up to the next microsecond.
+ * Every element costs its time on the wire plus up to two passes of the driver polling loop, the loop
+ * sees a received frame within one pass and sends the next frame on the following one. With the loop cost of the target the result
+ * is an upper bound of a transfer that is not preempted and can be used as its timeout, add the
+ * preemption time allowed by the application and the wait for the bus lock if the bus is shared.
+ * With Copy_u32LoopCycles at 0 the result is the wire time alone, a lower bound.
  *
- * @param Copy_u8SPIx
- * This parameter can be a value of @ref SPIx
+ * @param Copy_u32PclkHz				APB clock feeding the SPI peripheral
+ * @param Copy_u8BaudRatePrescaler		This parameter can be a value of @ref SPI_BaudRate_Prescaler
+ * @param Copy_u16ElementsNo			Amount of data elements to be transferred
  *
- * @param Copy_pfCallBackFunc	Specifies the function to be called when the SPI_IT_TXE interrupt happen.
+ * @param Copy_boolDataSize				Specifies the SPI data size
+ * This parameter can be a value of @ref SPI_Data_Size
  *
- * @retval None
+ * @param Copy_u32LoopCycles			PCLK cycles spent by one pass of the polling loop, the loop_cycles
+ * of tools/SPI_trace_host.cpp replay, which can be tuned until the replay matches a recorded trace
+ *
+ * @retval Transfer duration in microseconds
  */
-void SPI_SetTxCallback(uint8_t Copy_u8SPIx, void(*Copy_pfCallBackFunc)(void))
+uint32_t SPI_u32PredictTransferUs(uint32_t Copy_u32PclkHz, uint8_t Copy_u8BaudRatePrescaler, uint16_t Copy_u16ElementsNo, bool Copy_boolDataSize,
+		uint32_t Copy_u32LoopCycles)
 {
-	if(Copy_pfCallBackFunc != nullptr)
+	uint32_t Loc_u32Us = 0U;
+
+	if(Copy_u32PclkHz != 0U)
 	{
-		switch(Copy_u8SPIx)
-		{
-			case 	SPI1:	Glo_pfCallBacks[0] = Copy_pfCallBackFunc;	break;
-			case 	SPI2:	Glo_pfCallBacks[2] = Copy_pfCallBackFunc;	break;
-			case 	SPI3:	Glo_pfCallBacks[4] = Copy_pfCallBackFunc;	break;
-			default  	:												break;
-		}
+		/* PCLK cycles = elements x ((bits x prescaler) + 2 polling loop passes) */
+		uint64_t Loc_u64Cycles = (uint64_t)Copy_u16ElementsNo *
+								 ((((Copy_boolDataSize == SPI_DATASIZE_16BIT) ? 16U : 8U) << ((Copy_u8BaudRatePrescaler & 0x07U) + 1U)) +
+								  (2U * (uint64_t)Copy_u32LoopCycles));
+
+		Loc_u32Us = (uint32_t)(((Loc_u64Cycles * 1000000U) + Copy_u32PclkHz - 1U) / Copy_u32PclkHz);
 	}
+
+	return Loc_u32Us;
 }
 
 /**
- * @fn void SPI_SetRxCallback(uint8_t, void(*)(void))
- * @brief
- *
- * @param Copy_u8SPIx
- * This parameter can be a value of @ref SPIx
+ * @fn void SPI_vSetPort(const SPI_Port_t*)
+ * @brief Registers the RTOS port hooks used for bus arbitration and for waiting inside the blocking transfers.
  *
- * @param Copy_pfCallBackFunc	Specifies the function to be called when the SPI_IT_RXNE interrupt happen.
+ * @param Copy_pxPort	Pointer to the port hooks, must stay valid while the driver is used,
+ * nullptr restores the bare-metal behavior. Call it before the scheduler starts.
  *
  * @retval None
  */
-void SPI_SetRxCallback(uint8_t Copy_u8SPIx, void(*Copy_pfCallBackFunc)(void))
+void SPI_vSetPort(const SPI_Port_t* Copy_pxPort)
 {
-	if(Copy_pfCallBackFunc != nullptr)
-	{
+	Glo_pxPort = (Copy_pxPort != nullptr) ? Copy_pxPort : &Glo_xBareMetalPort;
+}
+
+/**
+ * @fn bool SPI_boolAcquire(uint8_t, uint32_t)
+ * @brief Takes ownership of a SPI instance for the calling task.
+ * The lock is recursive, every successful call must be matched by a SPI_vRelease call.
+ * While a higher priority task waits, the owner inherits its priority until it releases its last bus lock.
+ * Use it to keep several transfers (for example a command and its response) in one bus transaction.
+ * Must not be called from an interrupt handler.
+ *
+ * @param Copy_u8SPIx		Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @param Copy_u32Timeout	Maximum time to wait for the bus in microseconds
+ *
+ * @retval true if the bus is owned by the calling task, false on timeout
+ */
+bool SPI_boolAcquire(uint8_t Copy_u8SPIx, uint32_t Copy_u32Timeout)
+{
+	bool Loc_boolAcquired = false;
+
+	if(SPI_pxPtrSelect(Copy_u8SPIx) != nullptr)
+	{
+		SPI_Lock_t* Loc_pxLock = &Glo_xLocks[SPI_INDEX(Copy_u8SPIx)];
+		void* Loc_pvSelf = SPI_pvCurrentTask();
+		uint64_t Loc_u64tickstart = micros();
+
+		while(true)
+		{
+			SPI_vEnterCritical();
+
+			if((Loc_pxLock -> pvOwner == nullptr) || (Loc_pxLock -> pvOwner == Loc_pvSelf))
+			{
+				if(Loc_pxLock -> u8Nesting == 0U)
+				{
+					SPI_Holder_t* Loc_pxHolder = SPI_pxHolderFind(Loc_pvSelf);
+
+					/* First bus lock of the task, its current priority is the original one */
+					if(Loc_pxHolder == nullptr)
+					{
+						Loc_pxHolder = SPI_pxHolderFind(nullptr);
+						Loc_pxHolder -> pvTask = Loc_pvSelf;
+						Loc_pxHolder -> u8LocksHeld = 0U;
+						Loc_pxHolder -> boolBoosted = false;
+						if(Glo_pxPort -> pfGetTaskPriority != nullptr)
+						{
+							Loc_pxHolder -> u8BasePriority = Glo_pxPort -> pfGetTaskPriority(Loc_pvSelf);
+						}
+					}
+					Loc_pxHolder -> u8LocksHeld++;
+					Loc_pxLock -> pvOwner = Loc_pvSelf;
+				}
+				Loc_pxLock -> u8Nesting++;
+				Loc_boolAcquired = true;
+			}
+			/* Priority inheritance: raise the owner to the priority of the waiting task */
+			else if((Glo_pxPort -> pfGetTaskPriority != nullptr) && (Glo_pxPort -> pfSetTaskPriority != nullptr))
+			{
+				uint8_t Loc_u8SelfPriority = Glo_pxPort -> pfGetTaskPriority(Loc_pvSelf);
+
+				if(Loc_u8SelfPriority > Glo_pxPort -> pfGetTaskPriority(Loc_pxLock -> pvOwner))
+				{
+					Glo_pxPort -> pfSetTaskPriority(Loc_pxLock -> pvOwner, Loc_u8SelfPriority);
+					SPI_pxHolderFind(Loc_pxLock -> pvOwner) -> boolBoosted = true;
+				}
+			}
+			else
+			{
+
+			}
+
+			SPI_vExitCritical();
+
+			if((Loc_boolAcquired == true) || ((micros() - Loc_u64tickstart) >= Copy_u32Timeout))
+			{
+				break;
+			}
+
+			/* Back-off, let the owner run */
+			if(Glo_pxPort -> pfSleepUs != nullptr)
+			{
+				Glo_pxPort -> pfSleepUs(SPI_LOCK_POLL_US);
+			}
+			else if(Glo_pxPort -> pfYield != nullptr)
+			{
+				Glo_pxPort -> pfYield();
+			}
+			else
+			{
+
+			}
+		}
+	}
+
+	return Loc_boolAcquired;
+}
+
+/**
+ * @fn void SPI_vRelease(uint8_t)
+ * @brief Releases one level of ownership of a SPI instance taken by SPI_boolAcquire.
+ * When the task releases the last level of its last bus lock it gets its original priority back.
+ *
+ * @param Copy_u8SPIx	Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @retval None
+ */
+void SPI_vRelease(uint8_t Copy_u8SPIx)
+{
+	if(SPI_pxPtrSelect(Copy_u8SPIx) != nullptr)
+	{
+		SPI_Lock_t* Loc_pxLock = &Glo_xLocks[SPI_INDEX(Copy_u8SPIx)];
+		void* Loc_pvSelf = SPI_pvCurrentTask();
+
+		SPI_vEnterCritical();
+
+		if((Loc_pxLock -> pvOwner == Loc_pvSelf) && (Loc_pxLock -> u8Nesting > 0U))
+		{
+			Loc_pxLock -> u8Nesting--;
+
+			if(Loc_pxLock -> u8Nesting == 0U)
+			{
+				SPI_Holder_t* Loc_pxHolder = SPI_pxHolderFind(Loc_pvSelf);
+
+				Loc_pxLock -> pvOwner = nullptr;
+				Loc_pxHolder -> u8LocksHeld--;
+
+				/* The inherited priority is kept while any other bus lock is still held */
+				if(Loc_pxHolder -> u8LocksHeld == 0U)
+				{
+					if((Loc_pxHolder -> boolBoosted == true) && (Glo_pxPort -> pfSetTaskPriority != nullptr))
+					{
+						Glo_pxPort -> pfSetTaskPriority(Loc_pvSelf, Loc_pxHolder -> u8BasePriority);
+					}
+					Loc_pxHolder -> pvTask = nullptr;
+				}
+			}
+		}
+
+		SPI_vExitCritical();
+	}
+}
+
+/**
+ * @fn uint8_t SPI_u8GetLastStatus(uint8_t)
+ * @brief Returns the outcome of the last blocking transfer made by the calling task on a SPI instance.
+ * Transfers of the other tasks do not change it. Up to SPI_STATUS_SLOTS (task, instance) pairs are kept.
+ *
+ * @param Copy_u8SPIx	Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @retval Transfer status, a value of @ref SPI_Status
+ */
+uint8_t SPI_u8GetLastStatus(uint8_t Copy_u8SPIx)
+{
+	uint8_t Loc_u8Status = SPI_STATUS_OK;
+
+	if(SPI_pxPtrSelect(Copy_u8SPIx) != nullptr)
+	{
+		void* Loc_pvSelf = SPI_pvCurrentTask();
+		uint8_t Loc_u8Index;
+
+		SPI_vEnterCritical();
+		for(Loc_u8Index = 0U; Loc_u8Index < SPI_STATUS_SLOTS; Loc_u8Index++)
+		{
+			if((Glo_xStatus[Loc_u8Index].pvTask == Loc_pvSelf) && (Glo_xStatus[Loc_u8Index].u8SPIx == Copy_u8SPIx))
+			{
+				Loc_u8Status = Glo_xStatus[Loc_u8Index].u8Status;
+				break;
+			}
+		}
+		SPI_vExitCritical();
+	}
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn bool SPI_boolStreamStart(uint8_t, uint8_t*, uint16_t, bool, void(*)(void), void(*)(void))
+ * @brief Start a gap-free continuous transmission of a ping-pong buffer driven by the TXE interrupt.
+ * The buffer is sent again and again: when its first half has been sent the half complete callback is
+ * called and the application refills that half while the second one is sent, then the complete callback
+ * is called for the second half. A refilled half is handed back with SPI_vStreamSubmit, a half that was
+ * not handed back in time is sent again and counted as an underrun.
+ * The bus stays owned by the calling task until SPI_vStreamStop is called from the same task,
+ * meanwhile the blocking and striped transfers on the instance return SPI_STATUS_BUSY.
+ * The SPI IRQ must be enabled in the NVIC.
+ *
+ * @param Copy_u8SPIx					Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @param Copy_pu8Buffer				Pointer to the ping-pong buffer, both halves filled before the call
+ * @param Copy_u16ElementsNo			Amount of data elements in the whole buffer, must be even
+ *
+ * @param Copy_boolDataSize				Specifies the SPI data size
+ * This parameter can be a value of @ref SPI_Data_Size
+ *
+ * @param Copy_pfHalfCpltCallBack		Called from the interrupt when the first half has been sent, may be nullptr
+ * @param Copy_pfCpltCallBack			Called from the interrupt when the second half has been sent, may be nullptr
+ *
+ * @retval true if the stream started, false on invalid parameters or if the bus is owned by another task
+ */
+bool SPI_boolStreamStart(uint8_t Copy_u8SPIx, uint8_t *Copy_pu8Buffer, uint16_t Copy_u16ElementsNo, bool Copy_boolDataSize,
+		void(*Copy_pfHalfCpltCallBack)(void), void(*Copy_pfCpltCallBack)(void))
+{
+	bool Loc_boolStarted = false;
+	SPI_t* Loc_pxSPI_t = SPI_pxPtrSelect(Copy_u8SPIx);
+
+	if((Loc_pxSPI_t != nullptr) && (Copy_pu8Buffer != nullptr) && (Copy_u16ElementsNo >= 2U) && ((Copy_u16ElementsNo & 1U) == 0U) &&
+	   (Glo_xStreams[SPI_INDEX(Copy_u8SPIx)].boolActive == false) && (SPI_boolAcquire(Copy_u8SPIx, 0U) == true))
+	{
+		SPI_Stream_t* Loc_pxStream = &Glo_xStreams[SPI_INDEX(Copy_u8SPIx)];
+
+		Loc_pxStream -> pu8Buffer		= Copy_pu8Buffer;
+		Loc_pxStream -> u16ElementsNo	= Copy_u16ElementsNo;
+		Loc_pxStream -> u16Index		= 0U;
+		Loc_pxStream -> boolDataSize	= Copy_boolDataSize;
+		Loc_pxStream -> aboolReady[SPI_STREAM_HALF_FIRST]  = true;
+		Loc_pxStream -> aboolReady[SPI_STREAM_HALF_SECOND] = true;
+		Loc_pxStream -> u32Underruns	= 0U;
+		Loc_pxStream -> pfHalfCplt		= Copy_pfHalfCpltCallBack;
+		Loc_pxStream -> pfCplt			= Copy_pfCpltCallBack;
+		Loc_pxStream -> boolActive		= true;
+
+		/* TXE is already set, the first element is written by the interrupt */
+		SPI_ENABLE_IT(Copy_u8SPIx, SPI_IT_TXE);
+
+		Loc_boolStarted = true;
+	}
+
+	return Loc_boolStarted;
+}
+
+/**
+ * @fn void SPI_vStreamSubmit(uint8_t, uint8_t)
+ * @brief Hand a refilled half of the ping-pong buffer back to the stream.
+ * Call it after the matching callback, once the half holds new data.
+ *
+ * @param Copy_u8SPIx		Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @param Copy_u8Half		Specifies the refilled half
+ * This parameter can be a value of @ref SPI_Stream_Half
+ *
+ * @retval None
+ */
+void SPI_vStreamSubmit(uint8_t Copy_u8SPIx, uint8_t Copy_u8Half)
+{
+	if((SPI_pxPtrSelect(Copy_u8SPIx) != nullptr) && (Copy_u8Half <= SPI_STREAM_HALF_SECOND))
+	{
+		Glo_xStreams[SPI_INDEX(Copy_u8SPIx)].aboolReady[Copy_u8Half] = true;
+	}
+}
+
+/**
+ * @fn void SPI_vStreamStop(uint8_t)
+ * @brief Stop a continuous transmission started by SPI_boolStreamStart and release the bus.
+ * The element being shifted out is completed by the hardware.
+ *
+ * @param Copy_u8SPIx		Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @retval None
+ */
+void SPI_vStreamStop(uint8_t Copy_u8SPIx)
+{
+	SPI_t* Loc_pxSPI_t = SPI_pxPtrSelect(Copy_u8SPIx);
+
+	if((Loc_pxSPI_t != nullptr) && (Glo_xStreams[SPI_INDEX(Copy_u8SPIx)].boolActive == true))
+	{
+		SPI_DISABLE_IT(Copy_u8SPIx, SPI_IT_TXE);
+		Glo_xStreams[SPI_INDEX(Copy_u8SPIx)].boolActive = false;
+
+		/* Received data was never read during the stream, clear RXNE and OVR (read DR then SR) */
+		(void)Loc_pxSPI_t -> DR;
+		(void)Loc_pxSPI_t -> SR.RegisterAccess;
+
+		SPI_vRelease(Copy_u8SPIx);
+	}
+}
+
+/**
+ * @fn uint32_t SPI_u32StreamGetUnderruns(uint8_t)
+ * @brief Returns how many halves were sent again because they were not submitted in time
+ *
+ * @param Copy_u8SPIx		Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @retval Underruns counted since the stream started
+ */
+uint32_t SPI_u32StreamGetUnderruns(uint8_t Copy_u8SPIx)
+{
+	uint32_t Loc_u32Underruns = 0U;
+
+	if(SPI_pxPtrSelect(Copy_u8SPIx) != nullptr)
+	{
+		Loc_u32Underruns = Glo_xStreams[SPI_INDEX(Copy_u8SPIx)].u32Underruns;
+	}
+
+	return Loc_u32Underruns;
+}
+
+/**
+ * @fn void SPI_vStreamIsr(uint8_t)
+ * @brief TXE interrupt service of a continuous transmission, sends the next element of the ping-pong buffer
+ *
+ * @param Copy_u8SPIx		Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @retval None
+ */
+static void SPI_vStreamIsr(uint8_t Copy_u8SPIx)
+{
+	SPI_t* Loc_pxSPI_t = SPI_pxPtrSelect(Copy_u8SPIx);
+	SPI_Stream_t* Loc_pxStream = &Glo_xStreams[SPI_INDEX(Copy_u8SPIx)];
+	uint16_t Loc_u16Half = Loc_pxStream -> u16ElementsNo >> 1;
+
+	/* Start of a half, it must have been refilled since it was last sent */
+	if((Loc_pxStream -> u16Index == 0U) || (Loc_pxStream -> u16Index == Loc_u16Half))
+	{
+		uint8_t Loc_u8Half = (Loc_pxStream -> u16Index == 0U) ? SPI_STREAM_HALF_FIRST : SPI_STREAM_HALF_SECOND;
+
+		if(Loc_pxStream -> aboolReady[Loc_u8Half] == false)
+		{
+			Loc_pxStream -> u32Underruns++;
+		}
+		Loc_pxStream -> aboolReady[Loc_u8Half] = false;
+	}
+
+	if(Loc_pxStream -> boolDataSize == SPI_DATASIZE_16BIT)
+	{
+		Loc_pxSPI_t -> DR = ((uint16_t*)Loc_pxStream -> pu8Buffer)[Loc_pxStream -> u16Index];
+	}
+	else
+	{
+		Loc_pxSPI_t -> DR = Loc_pxStream -> pu8Buffer[Loc_pxStream -> u16Index];
+	}
+
+	Loc_pxStream -> u16Index++;
+
+	if(Loc_pxStream -> u16Index == Loc_u16Half)
+	{
+		if(Loc_pxStream -> pfHalfCplt != nullptr)
+		{
+			Loc_pxStream -> pfHalfCplt();
+		}
+	}
+	else if(Loc_pxStream -> u16Index == Loc_pxStream -> u16ElementsNo)
+	{
+		Loc_pxStream -> u16Index = 0U;
+		if(Loc_pxStream -> pfCplt != nullptr)
+		{
+			Loc_pxStream -> pfCplt();
+		}
+	}
+	else
+	{
+
+	}
+}
+
+/**
+ * @fn bool SPI_boolStripeInit(SPI_Stripe_t*, const uint8_t*, uint8_t, uint16_t, bool, bool, bool, bool, bool, bool, bool, uint8_t, bool, void(*)(void))
+ * @brief Initialize a striped bus, every lane is initialized by SPI_vInit with the same configuration
+ *
+ * @param Copy_pxStripe					Pointer to the striped bus to initialize
+ * @param Copy_pu8Lanes					Array of lane instances, values of @ref SPIx, each used once
+ * @param Copy_u8LanesNo				Number of lanes, from 1 to SPI_STRIPE_MAX_LANES
+ * @param Copy_u16StripeUnit			Consecutive elements sent on a lane before moving to the next one,
+ * typically the device page or sector size so each device gets whole pages
+ *
+ * @param Copy_boolMode ... Copy_boolFirstBit	Lane configuration, see SPI_vInit
+ *
+ * @param Copy_pfCpltCallBack			Called once all the lanes completed a transfer, may be nullptr
+ *
+ * @retval true if the striped bus is usable, false on invalid parameters (unknown or repeated lane),
+ * the striped bus is then left with no lane and refused by SPI_u8StripeTransmitReceive
+ */
+bool SPI_boolStripeInit(SPI_Stripe_t* Copy_pxStripe, const uint8_t* Copy_pu8Lanes, uint8_t Copy_u8LanesNo, uint16_t Copy_u16StripeUnit,
+		bool Copy_boolMode, bool Copy_boolDataSize, bool Copy_boolCLKPolarity, bool Copy_boolCLKPhase, bool Copy_boolSSM, bool Copy_boolSSI,
+		bool Copy_boolSSOE, uint8_t Copy_u8BaudRatePrescaler, bool Copy_boolFirstBit, void(*Copy_pfCpltCallBack)(void))
+{
+	bool Loc_boolValid = false;
+	uint8_t Loc_u8Lane;
+
+	if(Copy_pxStripe == nullptr)
+	{
+		return Loc_boolValid;
+	}
+
+	Copy_pxStripe -> u8LanesNo = 0U;
+
+	if((SPI_boolLanesValid(Copy_pu8Lanes, Copy_u8LanesNo) == true) && (Copy_u16StripeUnit != 0U))
+	{
+		Loc_boolValid = true;
+		Copy_pxStripe -> u8LanesNo		= Copy_u8LanesNo;
+		Copy_pxStripe -> u16StripeUnit	= Copy_u16StripeUnit;
+		Copy_pxStripe -> boolDataSize	= Copy_boolDataSize;
+		Copy_pxStripe -> pfCpltCallBack	= Copy_pfCpltCallBack;
+
+		for(Loc_u8Lane = 0U; Loc_u8Lane < Copy_u8LanesNo; Loc_u8Lane++)
+		{
+			Copy_pxStripe -> au8Lanes[Loc_u8Lane] = Copy_pu8Lanes[Loc_u8Lane];
+			SPI_vInit(Copy_pu8Lanes[Loc_u8Lane], Copy_boolMode, Copy_boolDataSize, Copy_boolCLKPolarity, Copy_boolCLKPhase, Copy_boolSSM,
+					Copy_boolSSI, Copy_boolSSOE, Copy_u8BaudRatePrescaler, Copy_boolFirstBit);
+		}
+	}
+
+	return Loc_boolValid;
+}
+
+/**
+ * @fn uint8_t SPI_u8StripeTransmitReceive(const SPI_Stripe_t*, uint8_t*, uint8_t*, uint16_t, uint32_t)
+ * @brief Transmit and Receive a logical buffer over all the lanes of a striped bus in blocking mode.
+ * The lanes are served in parallel by one polling loop, each lane shifts its part of the buffer
+ * while the others are serviced, then the received parts are put back in logical order.
+ * All the lane bus locks are held during the transfer.
+ *
+ * @param Copy_pxStripe					Pointer to the striped bus
+ * @param Copy_pu8TxData				Pointer to the logical transmission buffer, nullptr sends 0xFF (receive only)
+ * @param Copy_pu8RxData				Pointer to the logical reception buffer, nullptr discards the received data (transmit only)
+ * @param Copy_u16ElementsNo			Amount of logical data elements, Elements No value start from one
+ * @param Copy_u32Timeout				Timeout duration of the whole transfer, also bounds the wait for the bus locks
+ *
+ * @retval Transfer status, a value of @ref SPI_Status, SPI_STATUS_INVALID if a lane is not a distinct SPI instance
+ * (striped bus refused by SPI_boolStripeInit)
+ */
+uint8_t SPI_u8StripeTransmitReceive(const SPI_Stripe_t* Copy_pxStripe, uint8_t *Copy_pu8TxData, uint8_t *Copy_pu8RxData,
+		uint16_t Copy_u16ElementsNo, uint32_t Copy_u32Timeout)
+{
+	uint8_t Loc_u8Status = SPI_STATUS_OK;
+	SPI_Lane_t Loc_axLanes[SPI_STRIPE_MAX_LANES];
+	uint8_t Loc_u8Lane;
+	uint8_t Loc_u8SPIx;
+	uint8_t Loc_u8Acquired = 0U;
+
+	if((Copy_pxStripe == nullptr) || (Copy_pxStripe -> u16StripeUnit == 0U) ||
+	   (SPI_boolLanesValid(Copy_pxStripe -> au8Lanes, Copy_pxStripe -> u8LanesNo) == false))
+	{
+		return SPI_STATUS_INVALID;
+	}
+
+	if(Copy_u16ElementsNo == 0U)
+	{
+		return Loc_u8Status;
+	}
+
+	/* Take the lane locks in instance order, whatever the lane order, so two striped buses can not deadlock */
+	for(Loc_u8SPIx = SPI1; (Loc_u8SPIx <= SPI3) && (Loc_u8Status == SPI_STATUS_OK); Loc_u8SPIx++)
+	{
+		for(Loc_u8Lane = 0U; Loc_u8Lane < Copy_pxStripe -> u8LanesNo; Loc_u8Lane++)
+		{
+			if(Copy_pxStripe -> au8Lanes[Loc_u8Lane] == Loc_u8SPIx)
+			{
+				if((Glo_xStreams[SPI_INDEX(Loc_u8SPIx)].boolActive == false) && (SPI_boolAcquire(Loc_u8SPIx, Copy_u32Timeout) == true))
+				{
+					Loc_u8Acquired |= (uint8_t)(1U << Loc_u8SPIx);
+				}
+				else
+				{
+					Loc_u8Status = SPI_STATUS_BUSY;
+				}
+				break;
+			}
+		}
+	}
+
+	if(Loc_u8Status == SPI_STATUS_OK)
+	{
+		uint32_t Loc_u32StripeSize = (uint32_t)Copy_pxStripe -> u16StripeUnit * Copy_pxStripe -> u8LanesNo;
+		uint32_t Loc_u32FullStripes = Copy_u16ElementsNo / Loc_u32StripeSize;
+		uint32_t Loc_u32Rest = Copy_u16ElementsNo % Loc_u32StripeSize;
+		uint16_t Loc_u16RxLeft = Copy_u16ElementsNo;
+		bool Loc_boolMaster = true;
+
+		/* Share the elements between the lanes */
+		for(Loc_u8Lane = 0U; Loc_u8Lane < Copy_pxStripe -> u8LanesNo; Loc_u8Lane++)
+		{
+			SPI_Lane_t* Loc_pxLane = &Loc_axLanes[Loc_u8Lane];
+			uint32_t Loc_u32LaneStart = (uint32_t)Loc_u8Lane * Copy_pxStripe -> u16StripeUnit;
+			uint32_t Loc_u32LaneRest = (Loc_u32Rest > Loc_u32LaneStart) ? (Loc_u32Rest - Loc_u32LaneStart) : 0U;
+
+			if(Loc_u32LaneRest > Copy_pxStripe -> u16StripeUnit)
+			{
+				Loc_u32LaneRest = Copy_pxStripe -> u16StripeUnit;
+			}
+
+			Loc_pxLane -> pxSPI			= SPI_pxPtrSelect(Copy_pxStripe -> au8Lanes[Loc_u8Lane]);
+			Loc_pxLane -> u16TxLeft		= (uint16_t)((Loc_u32FullStripes * Copy_pxStripe -> u16StripeUnit) + Loc_u32LaneRest);
+			Loc_pxLane -> u16RxLeft		= Loc_pxLane -> u16TxLeft;
+			Loc_pxLane -> u32TxIndex	= Loc_u32LaneStart;
+			Loc_pxLane -> u32RxIndex	= Loc_u32LaneStart;
+			Loc_pxLane -> u16TxInUnit	= 0U;
+			Loc_pxLane -> u16RxInUnit	= 0U;
+			Loc_pxLane -> boolTxAllowed	= true;
+
+			/* A slave lane is clocked from outside, the loop must keep polling it */
+			if(Loc_pxLane -> pxSPI -> CR1.BitAccess.MSTR != SPI_MODE_MASTER)
+			{
+				Loc_boolMaster = false;
+			}
+		}
+
+		/* Init tickstart for timeout management*/
+		SPI_Wait_t Loc_xWait;
+		SPI_vWaitInit(&Loc_xWait, Loc_u16RxLeft, Loc_boolMaster);
+
+		while(Loc_u16RxLeft > 0U)
+		{
+			for(Loc_u8Lane = 0U; Loc_u8Lane < Copy_pxStripe -> u8LanesNo; Loc_u8Lane++)
+			{
+				SPI_Lane_t* Loc_pxLane = &Loc_axLanes[Loc_u8Lane];
+
+				/* Check TXE flag */
+				if((Loc_pxLane -> u16TxLeft > 0U) && (Loc_pxLane -> boolTxAllowed == true) && (Loc_pxLane -> pxSPI -> SR.BitAccess.TXE))
+				{
+					if(Copy_pu8TxData == nullptr)
+					{
+						Loc_pxLane -> pxSPI -> DR = 0xFFFFU;
+					}
+					else if(Copy_pxStripe -> boolDataSize == SPI_DATASIZE_16BIT)
+					{
+						Loc_pxLane -> pxSPI -> DR = ((uint16_t*)Copy_pu8TxData)[Loc_pxLane -> u32TxIndex];
+					}
+					else
+					{
+						Loc_pxLane -> pxSPI -> DR = Copy_pu8TxData[Loc_pxLane -> u32TxIndex];
+					}
+					SPI_vLaneNext(&Loc_pxLane -> u32TxIndex, &Loc_pxLane -> u16TxInUnit, Copy_pxStripe);
+					Loc_pxLane -> u16TxLeft--;
+					/* Next Data is a reception (Rx). Tx not allowed */
+					Loc_pxLane -> boolTxAllowed = false;
+				}
+
+				/* Check RXNE flag */
+				if((Loc_pxLane -> u16RxLeft > 0U) && (Loc_pxLane -> pxSPI -> SR.BitAccess.RXNE))
+				{
+					uint16_t Loc_u16Data = (uint16_t)Loc_pxLane -> pxSPI -> DR;
+
+					if(Copy_pu8RxData != nullptr)
+					{
+						if(Copy_pxStripe -> boolDataSize == SPI_DATASIZE_16BIT)
+						{
+							((uint16_t*)Copy_pu8RxData)[Loc_pxLane -> u32RxIndex] = Loc_u16Data;
+						}
+						else
+						{
+							Copy_pu8RxData[Loc_pxLane -> u32RxIndex] = (uint8_t)Loc_u16Data;
+						}
+					}
+					SPI_vLaneNext(&Loc_pxLane -> u32RxIndex, &Loc_pxLane -> u16RxInUnit, Copy_pxStripe);
+					Loc_pxLane -> u16RxLeft--;
+					Loc_u16RxLeft--;
+					/* Next Data is a Transmission (Tx). Tx is allowed */
+					Loc_pxLane -> boolTxAllowed = true;
+				}
+			}
+
+			/* Timeout management */
+			if(SPI_boolWaitTimeout(&Loc_xWait, Loc_u16RxLeft, Copy_u32Timeout))
+			{
+				Loc_u8Status = SPI_STATUS_TIMEOUT;
+				break;
+			}
+		}
+	}
+
+	for(Loc_u8SPIx = SPI1; Loc_u8SPIx <= SPI3; Loc_u8SPIx++)
+	{
+		if((Loc_u8Acquired & (1U << Loc_u8SPIx)) != 0U)
+		{
+			SPI_vSetStatus(Loc_u8SPIx, Loc_u8Status);
+			SPI_vRelease(Loc_u8SPIx);
+		}
+	}
+
+	if((Loc_u8Status == SPI_STATUS_OK) && (Copy_pxStripe -> pfCpltCallBack != nullptr))
+	{
+		Copy_pxStripe -> pfCpltCallBack();
+	}
+
+	return Loc_u8Status;
+}
+
+/**
+ * @fn bool SPI_boolLanesValid(const uint8_t*, uint8_t)
+ * @brief Check the lanes of a striped bus, two lanes on one peripheral would mix their data
+ *
+ * @param Copy_pu8Lanes			Array of lane instances
+ * @param Copy_u8LanesNo		Number of lanes
+ *
+ * @retval true if there are 1 to SPI_STRIPE_MAX_LANES lanes, each an existing instance used once
+ */
+static bool SPI_boolLanesValid(const uint8_t* Copy_pu8Lanes, uint8_t Copy_u8LanesNo)
+{
+	bool Loc_boolValid = (Copy_pu8Lanes != nullptr) && (Copy_u8LanesNo != 0U) && (Copy_u8LanesNo <= SPI_STRIPE_MAX_LANES);
+	uint8_t Loc_u8Lane, Loc_u8Other;
+
+	for(Loc_u8Lane = 0U; (Loc_boolValid == true) && (Loc_u8Lane < Copy_u8LanesNo); Loc_u8Lane++)
+	{
+		if(SPI_pxPtrSelect(Copy_pu8Lanes[Loc_u8Lane]) == nullptr)
+		{
+			Loc_boolValid = false;
+		}
+		for(Loc_u8Other = 0U; Loc_u8Other < Loc_u8Lane; Loc_u8Other++)
+		{
+			if(Copy_pu8Lanes[Loc_u8Other] == Copy_pu8Lanes[Loc_u8Lane])
+			{
+				Loc_boolValid = false;
+			}
+		}
+	}
+
+	return Loc_boolValid;
+}
+
+/**
+ * @fn void SPI_vLaneNext(uint32_t*, uint16_t*, const SPI_Stripe_t*)
+ * @brief Move a lane cursor to its next logical element, skipping the units owned by the other lanes
+ *
+ * @param Copy_pu32Index		Pointer to the logical index of the lane cursor
+ * @param Copy_pu16InUnit		Pointer to the position of the cursor in its stripe unit
+ * @param Copy_pxStripe			Pointer to the striped bus
+ *
+ * @retval None
+ */
+static void SPI_vLaneNext(uint32_t* Copy_pu32Index, uint16_t* Copy_pu16InUnit, const SPI_Stripe_t* Copy_pxStripe)
+{
+	(*Copy_pu32Index)++;
+	(*Copy_pu16InUnit)++;
+
+	if(*Copy_pu16InUnit == Copy_pxStripe -> u16StripeUnit)
+	{
+		*Copy_pu16InUnit = 0U;
+		*Copy_pu32Index += (uint32_t)(Copy_pxStripe -> u8LanesNo - 1U) * Copy_pxStripe -> u16StripeUnit;
+	}
+}
+
+/**
+ * @fn const void* SPI_pvGetTrace(uint32_t*)
+ * @brief Gives access to the trace ring so it can be sent to a host (UART, debugger dump...).
+ * The ring starts with a SPI_TraceHeader_t, see tools/SPI_trace_host.cpp for the decoder.
+ *
+ * @param Copy_pu32Size		Pointer to the returned ring size in bytes, may be nullptr
+ *
+ * @retval Pointer to the ring, nullptr when SPI_TRACE_ENABLE is 0
+ */
+const void* SPI_pvGetTrace(uint32_t* Copy_pu32Size)
+{
+	const void* Loc_pvTrace = nullptr;
+	uint32_t Loc_u32Size = 0U;
+
+#if SPI_TRACE_ENABLE
+	Loc_pvTrace = &Glo_xTrace;
+	Loc_u32Size = sizeof(Glo_xTrace);
+#endif
+
+	if(Copy_pu32Size != nullptr)
+	{
+		*Copy_pu32Size = Loc_u32Size;
+	}
+
+	return Loc_pvTrace;
+}
+
+/**
+ * @fn void SPI_vClearTrace(void)
+ * @brief Restart the trace recording from an empty ring
+ *
+ * @retval None
+ */
+void SPI_vClearTrace(void)
+{
+#if SPI_TRACE_ENABLE
+	SPI_vEnterCritical();
+	Glo_xTrace.xHeader.u32Count = 0U;
+	SPI_vExitCritical();
+#endif
+}
+
+/**
+ * @brief  Enable the specified SPI interrupts.
+ * @param  Copy_u8SPIx			Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @param  Copy_u8Interrupt 	Specifies the interrupt source to enable.
+ * This parameter can be a value of @ref SPI_Interrupt_definition
+ *
+ * @retval None
+ */
+void SPI_ENABLE_IT(uint8_t Copy_u8SPIx, uint8_t Copy_u8Interrupt)
+{
+	SPI_t* Loc_pxSPI_t = SPI_pxPtrSelect(Copy_u8SPIx);
+
+	if(Loc_pxSPI_t != nullptr)
+	{
+		Loc_pxSPI_t->CR2.RegisterAccess |= 1 << Copy_u8Interrupt;
+	}
+}
+
+/**
+ * @brief  Disable the specified SPI interrupts.
+ * @param  Copy_u8SPIx			Specifies which SPI handler to use
+ * This parameter can be a value of @ref SPIx
+ *
+ * @param  Copy_u8Interrupt 	Specifies the interrupt source to disable.
+ * This parameter can be a value of @ref SPI_Interrupt_definition
+ *
+ * @retval None
+ */
+void SPI_DISABLE_IT(uint8_t Copy_u8SPIx, uint8_t Copy_u8Interrupt)
+{
+	SPI_t* Loc_pxSPI_t = SPI_pxPtrSelect(Copy_u8SPIx);
+
+	if(Loc_pxSPI_t != nullptr)
+	{
+		Loc_pxSPI_t->CR2.RegisterAccess &= ~(1 << Copy_u8Interrupt);
+	}
+}
+
+/**
+ * @fn void SPI_SetTxCallback(uint8_t, void(*)(void))
+ * @brief
+ *
+ * @param Copy_u8SPIx
+ * This parameter can be a value of @ref SPIx
+ *
+ * @param Copy_pfCallBackFunc	Specifies the function to be called when the SPI_IT_TXE interrupt happen.
+ *
+ * @retval None
+ */
+void SPI_SetTxCallback(uint8_t Copy_u8SPIx, void(*Copy_pfCallBackFunc)(void))
+{
+	if(Copy_pfCallBackFunc != nullptr)
+	{
+		switch(Copy_u8SPIx)
+		{
+			case 	SPI1:	Glo_pfCallBacks[0] = Copy_pfCallBackFunc;	break;
+			case 	SPI2:	Glo_pfCallBacks[2] = Copy_pfCallBackFunc;	break;
+			case 	SPI3:	Glo_pfCallBacks[4] = Copy_pfCallBackFunc;	break;
+			default  	:												break;
+		}
+	}
+}
+
+/**
+ * @fn void SPI_SetRxCallback(uint8_t, void(*)(void))
+ * @brief
+ *
+ * @param Copy_u8SPIx
+ * This parameter can be a value of @ref SPIx
+ *
+ * @param Copy_pfCallBackFunc	Specifies the function to be called when the SPI_IT_RXNE interrupt happen.
+ *
+ * @retval None
+ */
+void SPI_SetRxCallback(uint8_t Copy_u8SPIx, void(*Copy_pfCallBackFunc)(void))
+{
+	if(Copy_pfCallBackFunc != nullptr)
+	{
 		switch(Copy_u8SPIx)
 		{
 			case 	SPI1:	Glo_pfCallBacks[1] = Copy_pfCallBackFunc;	break;
@@ -482,8 +1705,13 @@ void SPI_SetRxCallback(uint8_t Copy_u8SPIx, void(*Copy_pfCallBackFunc)(void))
 extern "C"{
 void SPI1_IRQHandler(void)
 {
+	/* Continuous transmission ---------------------------------------------------------------*/
+	if((Glo_xStreams[SPI_INDEX(SPI1)].boolActive == true) && (((SPI_t*)SPI1_BASE_ADDRESS)->SR.BitAccess.TXE != 0))
+	{
+		SPI_vStreamIsr(SPI1);
+	}
 	/* SPI in mode Transmitter ----------------------------------------------------------*/
-	if((((SPI_t*)SPI1_BASE_ADDRESS)->SR.BitAccess.TXE != 0) && (Glo_pfCallBacks[0] != 0))
+	else if((((SPI_t*)SPI1_BASE_ADDRESS)->SR.BitAccess.TXE != 0) && (Glo_pfCallBacks[0] != 0))
 	{
 		Glo_pfCallBacks[0]();
 	}
@@ -500,8 +1728,13 @@ void SPI1_IRQHandler(void)
 
 void SPI2_IRQHandler(void)
 {
+	/* Continuous transmission ---------------------------------------------------------------*/
+	if((Glo_xStreams[SPI_INDEX(SPI2)].boolActive == true) && (((SPI_t*)SPI2_BASE_ADDRESS)->SR.BitAccess.TXE != 0))
+	{
+		SPI_vStreamIsr(SPI2);
+	}
 	/* SPI in mode Transmitter ---------------------------------------------------------*/
-	if((((SPI_t*)SPI2_BASE_ADDRESS)->SR.BitAccess.TXE != 0) && (Glo_pfCallBacks[2] != 0))
+	else if((((SPI_t*)SPI2_BASE_ADDRESS)->SR.BitAccess.TXE != 0) && (Glo_pfCallBacks[2] != 0))
 	{
 		Glo_pfCallBacks[2]();
 	}
@@ -518,8 +1751,13 @@ void SPI2_IRQHandler(void)
 
 void SPI3_IRQHandler(void)
 {
+	/* Continuous transmission ---------------------------------------------------------------*/
+	if((Glo_xStreams[SPI_INDEX(SPI3)].boolActive == true) && (((SPI_t*)SPI3_BASE_ADDRESS)->SR.BitAccess.TXE != 0))
+	{
+		SPI_vStreamIsr(SPI3);
+	}
 	/* SPI in mode Transmitter ----------------------------------------------------------*/
-	if((((SPI_t*)SPI3_BASE_ADDRESS)->SR.BitAccess.TXE != 0) && (Glo_pfCallBacks[4] != 0))
+	else if((((SPI_t*)SPI3_BASE_ADDRESS)->SR.BitAccess.TXE != 0) && (Glo_pfCallBacks[4] != 0))
 	{
 		Glo_pfCallBacks[4]();
 	}
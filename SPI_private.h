@@ -75,10 +75,99 @@ typedef struct
 	volatile uint32_t 	I2SPR  ;
 }SPI_t;
 
+typedef struct
+{
+	void*		pvOwner;				/* Task currently owning the bus, nullptr when free			*/
+	uint8_t		u8Nesting;				/* Recursive acquisitions made by the owner					*/
+}SPI_Lock_t;
+
+typedef struct
+{
+	void*		pvTask;					/* Task holding at least one bus lock, nullptr when free	*/
+	uint8_t		u8LocksHeld;			/* Bus locks held by the task, recursion not counted		*/
+	uint8_t		u8BasePriority;			/* Task priority before it took its first bus lock			*/
+	bool		boolBoosted;			/* Task priority was raised by a higher priority waiter		*/
+}SPI_Holder_t;
+
+typedef struct
+{
+	void*		pvTask;					/* Task the status belongs to, nullptr when free			*/
+	uint8_t		u8SPIx;
+	uint8_t		u8Status;				/* Outcome of its last blocking transfer on u8SPIx			*/
+}SPI_Status_t;
+
+typedef struct
+{
+	uint64_t	u64TickStart;			/* Transfer start, used for the timeout						*/
+	uint64_t	u64StallStart;			/* Time of the last observed progress on the bus			*/
+	uint16_t	u16Remaining;			/* Remaining elements at the last observed progress			*/
+	bool		boolMayYield;			/* The driver clocks the bus, a stall can give the CPU away	*/
+}SPI_Wait_t;
+
+typedef struct
+{
+	uint8_t*			pu8Buffer;			/* Ping-pong buffer, first half then second half			*/
+	uint16_t			u16ElementsNo;		/* Data elements in the whole buffer						*/
+	uint16_t			u16Index;			/* Next data element to send								*/
+	bool				boolDataSize;
+	volatile bool		boolActive;
+	volatile bool		aboolReady[2];		/* Half refilled by the application since it was sent		*/
+	volatile uint32_t	u32Underruns;		/* Halves sent again because they were not refilled in time	*/
+	void(*pfHalfCplt)(void);
+	void(*pfCplt)(void);
+}SPI_Stream_t;
+
+typedef struct
+{
+	SPI_t*		pxSPI;
+	uint16_t	u16TxLeft;				/* Elements left to send on the lane						*/
+	uint16_t	u16RxLeft;				/* Elements left to receive on the lane						*/
+	uint32_t	u32TxIndex;				/* Logical index of the next element to send				*/
+	uint32_t	u32RxIndex;				/* Logical index of the next element to receive				*/
+	uint16_t	u16TxInUnit;			/* Elements sent in the current stripe unit					*/
+	uint16_t	u16RxInUnit;			/* Elements received in the current stripe unit				*/
+	bool		boolTxAllowed;
+}SPI_Lane_t;
+
+#if SPI_TRACE_ENABLE
+typedef struct
+{
+	SPI_TraceRecord_t	xRecord;
+#if SPI_TRACE_DATA_BYTES > 0U
+	uint8_t				au8Data[SPI_TRACE_DATA_BYTES];
+#endif
+}SPI_TraceSlot_t;
+
+typedef struct
+{
+	SPI_TraceHeader_t	xHeader;
+	SPI_TraceSlot_t		axSlots[SPI_TRACE_DEPTH];
+}SPI_Trace_t;
+#endif
+
 #define SPI1_BASE_ADDRESS		0x40013000
 #define SPI2_BASE_ADDRESS		0x40013800
 #define SPI3_BASE_ADDRESS		0x40013C00
 
+#define SPI_INSTANCES_NO		3U
+#define SPI_INDEX(SPIx)			((SPIx) - 1U)
+
+/* Back-off between two attempts to take a bus owned by another task */
+#define SPI_LOCK_POLL_US		50U
+
 static SPI_t* SPI_pxPtrSelect(uint8_t Copy_u8SpiNum);
+static void* SPI_pvCurrentTask(void);
+static SPI_Holder_t* SPI_pxHolderFind(void* Copy_pvTask);
+static void SPI_vSetStatus(uint8_t Copy_u8SPIx, uint8_t Copy_u8Status);
+static void SPI_vEnterCritical(void);
+static void SPI_vExitCritical(void);
+static void SPI_vWaitInit(SPI_Wait_t* Copy_pxWait, uint16_t Copy_u16Remaining, bool Copy_boolMayYield);
+static bool SPI_boolWaitTimeout(SPI_Wait_t* Copy_pxWait, uint16_t Copy_u16Remaining, uint32_t Copy_u32Timeout);
+static void SPI_vStreamIsr(uint8_t Copy_u8SPIx);
+static bool SPI_boolLanesValid(const uint8_t* Copy_pu8Lanes, uint8_t Copy_u8LanesNo);
+static void SPI_vLaneNext(uint32_t* Copy_pu32Index, uint16_t* Copy_pu16InUnit, const SPI_Stripe_t* Copy_pxStripe);
+static void* SPI_pvTraceStart(uint8_t Copy_u8SPIx, uint8_t Copy_u8Operation, uint16_t Copy_u16ElementsNo, const uint8_t* Copy_pu8TxData);
+static void SPI_vTraceRecord(void* Copy_pvSlot, uint8_t Copy_u8SPIx, const SPI_Wait_t* Copy_pxWait, uint16_t Copy_u16Remaining,
+		const uint8_t* Copy_pu8RxData);
 
 #endif
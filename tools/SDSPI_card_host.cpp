@@ -0,0 +1,809 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+/************************************************************************************
+ * Host SD card model and SDSPI checks.												*
+ *																					*
+ * Build:	g++ -std=c++11 -O2 -Itools/host/inc -o SDSPI_card_host					*
+ *				tools/SDSPI_card_host.cpp SDSPI_module.cpp							*
+ *			add -DSDSPI_CRC_ENABLE=1 to run the checks with CMD59 CRC checking		*
+ * Usage:	SDSPI_card_host															*
+ *																					*
+ * The SPI driver is replaced by a byte loopback into a model of an SD card in		*
+ * SPI mode: CMD0/8/55/41/58/59/16, CMD17/18/12 reads, CMD24/25 writes with			*
+ * ACMD23 pre-erase, CRC7 and CRC16 checking when CRC is on. Pre-erased blocks		*
+ * that are not written are filled with MODEL_ERASED_BYTE, as their contents are	*
+ * undefined on a real card. The checks run on a high capacity card (block			*
+ * addressing) then on a standard capacity card (byte addressing).					*
+ * The exit code is the number of failed checks.									*
+ ***********************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <deque>
+#include <vector>
+#include "../SPI_interface.h"
+#include "../SDSPI_interface.h"
+
+#define MODEL_SECTORS				256U
+#define MODEL_ERASED_BYTE			0xEEU
+#define MODEL_ACMD41_POLLS			3U			/* ACMD41 calls answered idle before the card is ready	*/
+#define MODEL_BUSY_BYTES			2U			/* Busy bytes after a block is programmed				*/
+
+#define MODEL_MODE_COMMAND			0U
+#define MODEL_MODE_READ				1U
+#define MODEL_MODE_WRITE			2U
+
+/* SD card in SPI mode, seen one byte at a time */
+typedef struct
+{
+	std::vector<uint8_t>	xMemory;
+	std::deque<uint8_t>		xOut;				/* Bytes to shift out on the next exchanges					*/
+	std::vector<uint8_t>	xBlock;				/* Data block being received, CRC included					*/
+	bool					boolHighCapacity;
+	bool					boolSelected;
+	bool					boolIdle;
+	bool					boolAppCmd;
+	bool					boolCrcOn;
+	bool					boolMulti;
+	bool					boolToken;			/* Start token of the block being received was seen			*/
+	bool					boolCorruptCrc;		/* Send a wrong CRC16 with the next read block				*/
+	uint8_t					u8Mode;
+	uint8_t					au8Frame[6];
+	uint8_t					u8FrameLength;
+	uint8_t					u8Acmd41Polls;
+	uint32_t				u32Block;			/* Next block to send or to write							*/
+	uint32_t				u32WriteStart;
+	uint32_t				u32PreEraseNext;	/* ACMD23 count, applies to the next CMD25					*/
+	uint32_t				u32PreErase;		/* ACMD23 count of the running CMD25						*/
+	uint32_t				au32Commands[64];
+	uint32_t				au32AppCommands[64];
+	std::vector<uint32_t>	xPreErases;			/* ACMD23 arguments											*/
+}MODEL_Card_t;
+
+static MODEL_Card_t Glo_xCard;
+static SDSPI_Card_t Glo_xSD;
+static uint32_t Glo_u32Failed = 0U;
+static uint8_t Glo_u8BusPrescaler = SPI_CLOCK_RATE_INVALID;		/* BR of the last SPI_vInit			*/
+
+uint64_t micros(void)
+{
+	struct timespec Loc_xNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &Loc_xNow);
+	return ((uint64_t)Loc_xNow.tv_sec * 1000000U) + ((uint64_t)Loc_xNow.tv_nsec / 1000U);
+}
+
+/**
+ * @fn uint8_t MODEL_u8Crc7(const uint8_t*, uint8_t)
+ * @brief CRC7 of a command frame, shifted left with the end bit set
+ */
+static uint8_t MODEL_u8Crc7(const uint8_t* Copy_pu8Data, uint8_t Copy_u8Length)
+{
+	uint8_t Loc_u8Crc = 0U;
+
+	for(uint8_t Loc_u8Index = 0U; Loc_u8Index < Copy_u8Length; Loc_u8Index++)
+	{
+		for(int8_t Loc_s8Bit = 7; Loc_s8Bit >= 0; Loc_s8Bit--)
+		{
+			uint8_t Loc_u8In = (uint8_t)((Copy_pu8Data[Loc_u8Index] >> Loc_s8Bit) & 1U);
+			uint8_t Loc_u8Msb = (uint8_t)((Loc_u8Crc >> 6) & 1U);
+
+			Loc_u8Crc = (uint8_t)((Loc_u8Crc << 1) & 0x7FU);
+			if((Loc_u8In ^ Loc_u8Msb) != 0U)
+			{
+				Loc_u8Crc ^= 0x09U;
+			}
+		}
+	}
+
+	return (uint8_t)((Loc_u8Crc << 1) | 1U);
+}
+
+/**
+ * @fn uint16_t MODEL_u16Crc16(const uint8_t*, uint32_t)
+ * @brief CRC16-CCITT of a data block, computed bit by bit
+ */
+static uint16_t MODEL_u16Crc16(const uint8_t* Copy_pu8Data, uint32_t Copy_u32Length)
+{
+	uint16_t Loc_u16Crc = 0U;
+
+	for(uint32_t Loc_u32Index = 0U; Loc_u32Index < Copy_u32Length; Loc_u32Index++)
+	{
+		Loc_u16Crc ^= (uint16_t)(Copy_pu8Data[Loc_u32Index] << 8);
+		for(uint8_t Loc_u8Bit = 0U; Loc_u8Bit < 8U; Loc_u8Bit++)
+		{
+			Loc_u16Crc = (Loc_u16Crc & 0x8000U) ? (uint16_t)((Loc_u16Crc << 1) ^ 0x1021U) : (uint16_t)(Loc_u16Crc << 1);
+		}
+	}
+
+	return Loc_u16Crc;
+}
+
+/**
+ * @fn uint8_t MODEL_u8Pattern(uint32_t, uint32_t, uint8_t)
+ * @brief Content of a byte of a sector for a given generation of data
+ */
+static uint8_t MODEL_u8Pattern(uint32_t Copy_u32Sector, uint32_t Copy_u32Byte, uint8_t Copy_u8Seed)
+{
+	return (uint8_t)((Copy_u32Sector * 131U) + (Copy_u32Byte * 7U) + (Copy_u8Seed * 29U) + (Copy_u32Byte >> 8));
+}
+
+/**
+ * @fn void MODEL_vReset(MODEL_Card_t*, bool)
+ * @brief Power on a card filled with the generation 0 pattern
+ */
+static void MODEL_vReset(MODEL_Card_t* Copy_pxCard, bool Copy_boolHighCapacity)
+{
+	Copy_pxCard -> xMemory.resize(MODEL_SECTORS * SDSPI_BLOCK_SIZE);
+	for(uint32_t Loc_u32Index = 0U; Loc_u32Index < Copy_pxCard -> xMemory.size(); Loc_u32Index++)
+	{
+		Copy_pxCard -> xMemory[Loc_u32Index] = MODEL_u8Pattern(Loc_u32Index / SDSPI_BLOCK_SIZE, Loc_u32Index % SDSPI_BLOCK_SIZE, 0U);
+	}
+	Copy_pxCard -> xOut.clear();
+	Copy_pxCard -> xBlock.clear();
+	Copy_pxCard -> boolHighCapacity = Copy_boolHighCapacity;
+	Copy_pxCard -> boolSelected = false;
+	Copy_pxCard -> boolIdle = true;
+	Copy_pxCard -> boolAppCmd = false;
+	Copy_pxCard -> boolCrcOn = false;
+	Copy_pxCard -> boolMulti = false;
+	Copy_pxCard -> boolToken = false;
+	Copy_pxCard -> boolCorruptCrc = false;
+	Copy_pxCard -> u8Mode = MODEL_MODE_COMMAND;
+	Copy_pxCard -> u8FrameLength = 0U;
+	Copy_pxCard -> u8Acmd41Polls = 0U;
+	Copy_pxCard -> u32PreEraseNext = 0U;
+	Copy_pxCard -> u32PreErase = 0U;
+	memset(Copy_pxCard -> au32Commands, 0, sizeof(Copy_pxCard -> au32Commands));
+	memset(Copy_pxCard -> au32AppCommands, 0, sizeof(Copy_pxCard -> au32AppCommands));
+	Copy_pxCard -> xPreErases.clear();
+}
+
+/**
+ * @fn void MODEL_vClearCounters(MODEL_Card_t*)
+ * @brief Restart the command counters of a check
+ */
+static void MODEL_vClearCounters(MODEL_Card_t* Copy_pxCard)
+{
+	memset(Copy_pxCard -> au32Commands, 0, sizeof(Copy_pxCard -> au32Commands));
+	memset(Copy_pxCard -> au32AppCommands, 0, sizeof(Copy_pxCard -> au32AppCommands));
+	Copy_pxCard -> xPreErases.clear();
+}
+
+/**
+ * @fn void MODEL_vBusy(MODEL_Card_t*)
+ * @brief Hold DO low for a while, the card is programming
+ */
+static void MODEL_vBusy(MODEL_Card_t* Copy_pxCard)
+{
+	for(uint8_t Loc_u8Index = 0U; Loc_u8Index < MODEL_BUSY_BYTES; Loc_u8Index++)
+	{
+		Copy_pxCard -> xOut.push_back(0x00U);
+	}
+}
+
+/**
+ * @fn void MODEL_vQueueBlock(MODEL_Card_t*)
+ * @brief Queue the next block of a read, or the out of range error token past the last sector
+ */
+static void MODEL_vQueueBlock(MODEL_Card_t* Copy_pxCard)
+{
+	Copy_pxCard -> xOut.push_back(0xFFU);
+
+	if(Copy_pxCard -> u32Block >= MODEL_SECTORS)
+	{
+		Copy_pxCard -> xOut.push_back(0x08U);
+		Copy_pxCard -> u8Mode = MODEL_MODE_COMMAND;
+		return;
+	}
+
+	const uint8_t* Loc_pu8Block = &Copy_pxCard -> xMemory[Copy_pxCard -> u32Block * SDSPI_BLOCK_SIZE];
+	uint16_t Loc_u16Crc = MODEL_u16Crc16(Loc_pu8Block, SDSPI_BLOCK_SIZE);
+
+	if(Copy_pxCard -> boolCorruptCrc == true)
+	{
+		Loc_u16Crc ^= 0x0001U;
+		Copy_pxCard -> boolCorruptCrc = false;
+	}
+
+	Copy_pxCard -> xOut.push_back(0xFEU);
+	Copy_pxCard -> xOut.insert(Copy_pxCard -> xOut.end(), Loc_pu8Block, Loc_pu8Block + SDSPI_BLOCK_SIZE);
+	Copy_pxCard -> xOut.push_back((uint8_t)(Loc_u16Crc >> 8));
+	Copy_pxCard -> xOut.push_back((uint8_t)Loc_u16Crc);
+	Copy_pxCard -> u32Block++;
+
+	if(Copy_pxCard -> boolMulti == false)
+	{
+		Copy_pxCard -> u8Mode = MODEL_MODE_COMMAND;
+	}
+}
+
+/**
+ * @fn void MODEL_vCommand(MODEL_Card_t*)
+ * @brief Execute a received command frame and queue its response
+ */
+static void MODEL_vCommand(MODEL_Card_t* Copy_pxCard)
+{
+	uint8_t Loc_u8Command = Copy_pxCard -> au8Frame[0] & 0x3FU;
+	uint32_t Loc_u32Argument = ((uint32_t)Copy_pxCard -> au8Frame[1] << 24) | ((uint32_t)Copy_pxCard -> au8Frame[2] << 16) |
+							   ((uint32_t)Copy_pxCard -> au8Frame[3] << 8) | Copy_pxCard -> au8Frame[4];
+	uint32_t Loc_u32Block = Copy_pxCard -> boolHighCapacity ? Loc_u32Argument : (Loc_u32Argument / SDSPI_BLOCK_SIZE);
+	bool Loc_boolApp = Copy_pxCard -> boolAppCmd;
+	uint8_t Loc_u8R1;
+
+	Copy_pxCard -> boolAppCmd = false;
+
+	/* CMD0 and CMD8 are always checked, the others once CMD59 enabled the CRC */
+	if(((Copy_pxCard -> boolCrcOn == true) || (Loc_u8Command == 0U) || (Loc_u8Command == 8U)) &&
+	   (Copy_pxCard -> au8Frame[5] != MODEL_u8Crc7(Copy_pxCard -> au8Frame, 5U)))
+	{
+		Copy_pxCard -> xOut.push_back(0xFFU);
+		Copy_pxCard -> xOut.push_back((uint8_t)((Copy_pxCard -> boolIdle ? 0x01U : 0x00U) | 0x08U));
+		return;
+	}
+
+	if(Loc_boolApp == true)
+	{
+		Copy_pxCard -> au32AppCommands[Loc_u8Command]++;
+	}
+	else
+	{
+		Copy_pxCard -> au32Commands[Loc_u8Command]++;
+	}
+
+	if((Loc_u8Command == 12U) && (Loc_boolApp == false))
+	{
+		/* Stuff byte, R1, then busy while the read stops */
+		Copy_pxCard -> xOut.clear();
+		Copy_pxCard -> u8Mode = MODEL_MODE_COMMAND;
+		Copy_pxCard -> xOut.push_back(0xFFU);
+		Copy_pxCard -> xOut.push_back(0x00U);
+		MODEL_vBusy(Copy_pxCard);
+		return;
+	}
+
+	Loc_u8R1 = Copy_pxCard -> boolIdle ? 0x01U : 0x00U;
+	Copy_pxCard -> xOut.push_back(0xFFU);
+
+	if(Loc_boolApp == true)
+	{
+		if(Loc_u8Command == 41U)
+		{
+			Copy_pxCard -> u8Acmd41Polls++;
+			if(Copy_pxCard -> u8Acmd41Polls >= MODEL_ACMD41_POLLS)
+			{
+				Copy_pxCard -> boolIdle = false;
+			}
+			Loc_u8R1 = Copy_pxCard -> boolIdle ? 0x01U : 0x00U;
+		}
+		else if(Loc_u8Command == 23U)
+		{
+			Copy_pxCard -> u32PreEraseNext = Loc_u32Argument & 0x007FFFFFU;
+			Copy_pxCard -> xPreErases.push_back(Copy_pxCard -> u32PreEraseNext);
+		}
+		else
+		{
+			Loc_u8R1 |= 0x04U;
+		}
+		Copy_pxCard -> xOut.push_back(Loc_u8R1);
+		return;
+	}
+
+	switch(Loc_u8Command)
+	{
+		case 0U:
+			Copy_pxCard -> boolIdle = true;
+			Copy_pxCard -> xOut.push_back(0x01U);
+			break;
+
+		case 8U:
+			Copy_pxCard -> xOut.push_back(Loc_u8R1);
+			Copy_pxCard -> xOut.push_back(0x00U);
+			Copy_pxCard -> xOut.push_back(0x00U);
+			Copy_pxCard -> xOut.push_back((uint8_t)((Loc_u32Argument >> 8) & 0x0FU));
+			Copy_pxCard -> xOut.push_back((uint8_t)Loc_u32Argument);
+			break;
+
+		case 55U:
+			Copy_pxCard -> boolAppCmd = true;
+			Copy_pxCard -> xOut.push_back(Loc_u8R1);
+			break;
+
+		case 58U:
+			Copy_pxCard -> xOut.push_back(Loc_u8R1);
+			Copy_pxCard -> xOut.push_back(Copy_pxCard -> boolHighCapacity ? 0xC0U : 0x80U);
+			Copy_pxCard -> xOut.push_back(0xFFU);
+			Copy_pxCard -> xOut.push_back(0x80U);
+			Copy_pxCard -> xOut.push_back(0x00U);
+			break;
+
+		case 59U:
+			Copy_pxCard -> boolCrcOn = ((Loc_u32Argument & 1U) != 0U);
+			Copy_pxCard -> xOut.push_back(Loc_u8R1);
+			break;
+
+		case 16U:
+			Copy_pxCard -> xOut.push_back((Loc_u32Argument == SDSPI_BLOCK_SIZE) ? Loc_u8R1 : (uint8_t)(Loc_u8R1 | 0x40U));
+			break;
+
+		case 17U:
+		case 18U:
+		case 24U:
+		case 25U:
+			if((Copy_pxCard -> boolIdle == true) || (Loc_u32Block >= MODEL_SECTORS) ||
+			   ((Copy_pxCard -> boolHighCapacity == false) && ((Loc_u32Argument % SDSPI_BLOCK_SIZE) != 0U)))
+			{
+				Copy_pxCard -> xOut.push_back((uint8_t)(Loc_u8R1 | 0x40U));
+				break;
+			}
+			Copy_pxCard -> xOut.push_back(0x00U);
+			Copy_pxCard -> u32Block = Loc_u32Block;
+			Copy_pxCard -> boolMulti = (Loc_u8Command == 18U) || (Loc_u8Command == 25U);
+			if((Loc_u8Command == 17U) || (Loc_u8Command == 18U))
+			{
+				Copy_pxCard -> u8Mode = MODEL_MODE_READ;
+			}
+			else
+			{
+				Copy_pxCard -> u8Mode = MODEL_MODE_WRITE;
+				Copy_pxCard -> boolToken = false;
+				Copy_pxCard -> u32WriteStart = Loc_u32Block;
+				Copy_pxCard -> u32PreErase = (Loc_u8Command == 25U) ? Copy_pxCard -> u32PreEraseNext : 0U;
+			}
+			Copy_pxCard -> u32PreEraseNext = 0U;
+			break;
+
+		default:
+			Copy_pxCard -> xOut.push_back((uint8_t)(Loc_u8R1 | 0x04U));
+			break;
+	}
+}
+
+/**
+ * @fn void MODEL_vWriteByte(MODEL_Card_t*, uint8_t)
+ * @brief Receive one byte of a CMD24 / CMD25 data phase
+ */
+static void MODEL_vWriteByte(MODEL_Card_t* Copy_pxCard, uint8_t Copy_u8Data)
+{
+	if(Copy_pxCard -> boolToken == false)
+	{
+		if(((Copy_u8Data == 0xFEU) && (Copy_pxCard -> boolMulti == false)) || ((Copy_u8Data == 0xFCU) && (Copy_pxCard -> boolMulti == true)))
+		{
+			Copy_pxCard -> boolToken = true;
+			Copy_pxCard -> xBlock.clear();
+		}
+		else if((Copy_u8Data == 0xFDU) && (Copy_pxCard -> boolMulti == true))
+		{
+			/* Stop token: pre-erased blocks that were not written lose their contents */
+			for(uint32_t Loc_u32Block = Copy_pxCard -> u32Block; (Loc_u32Block < (Copy_pxCard -> u32WriteStart + Copy_pxCard -> u32PreErase)) &&
+				(Loc_u32Block < MODEL_SECTORS); Loc_u32Block++)
+			{
+				memset(&Copy_pxCard -> xMemory[Loc_u32Block * SDSPI_BLOCK_SIZE], MODEL_ERASED_BYTE, SDSPI_BLOCK_SIZE);
+			}
+			Copy_pxCard -> xOut.push_back(0xFFU);
+			MODEL_vBusy(Copy_pxCard);
+			Copy_pxCard -> u8Mode = MODEL_MODE_COMMAND;
+		}
+		else
+		{
+
+		}
+		return;
+	}
+
+	Copy_pxCard -> xBlock.push_back(Copy_u8Data);
+
+	if(Copy_pxCard -> xBlock.size() == (SDSPI_BLOCK_SIZE + 2U))
+	{
+		uint16_t Loc_u16Crc = (uint16_t)((Copy_pxCard -> xBlock[SDSPI_BLOCK_SIZE] << 8) | Copy_pxCard -> xBlock[SDSPI_BLOCK_SIZE + 1U]);
+
+		Copy_pxCard -> boolToken = false;
+
+		if((Copy_pxCard -> boolCrcOn == true) && (Loc_u16Crc != MODEL_u16Crc16(&Copy_pxCard -> xBlock[0], SDSPI_BLOCK_SIZE)))
+		{
+			Copy_pxCard -> xOut.push_back(0xEBU);
+		}
+		else if(Copy_pxCard -> u32Block >= MODEL_SECTORS)
+		{
+			Copy_pxCard -> xOut.push_back(0xEDU);
+		}
+		else
+		{
+			memcpy(&Copy_pxCard -> xMemory[Copy_pxCard -> u32Block * SDSPI_BLOCK_SIZE], &Copy_pxCard -> xBlock[0], SDSPI_BLOCK_SIZE);
+			Copy_pxCard -> u32Block++;
+			Copy_pxCard -> xOut.push_back(0xE5U);
+		}
+		MODEL_vBusy(Copy_pxCard);
+
+		if(Copy_pxCard -> boolMulti == false)
+		{
+			Copy_pxCard -> u8Mode = MODEL_MODE_COMMAND;
+		}
+	}
+}
+
+/**
+ * @fn uint8_t MODEL_u8Exchange(MODEL_Card_t*, uint8_t)
+ * @brief One SPI byte: the card shifts out its next byte while it receives the host byte
+ */
+static uint8_t MODEL_u8Exchange(MODEL_Card_t* Copy_pxCard, uint8_t Copy_u8Data)
+{
+	uint8_t Loc_u8Out = 0xFFU;
+
+	if(Copy_pxCard -> boolSelected == false)
+	{
+		return Loc_u8Out;
+	}
+
+	if((Copy_pxCard -> xOut.empty() == true) && (Copy_pxCard -> u8Mode == MODEL_MODE_READ))
+	{
+		MODEL_vQueueBlock(Copy_pxCard);
+	}
+	if(Copy_pxCard -> xOut.empty() == false)
+	{
+		Loc_u8Out = Copy_pxCard -> xOut.front();
+		Copy_pxCard -> xOut.pop_front();
+	}
+
+	if(Copy_pxCard -> u8Mode == MODEL_MODE_WRITE)
+	{
+		MODEL_vWriteByte(Copy_pxCard, Copy_u8Data);
+	}
+	/* Commands start with 01b, the dummy bytes sent meanwhile are 0xFF */
+	else if((Copy_pxCard -> u8FrameLength != 0U) || ((Copy_u8Data & 0xC0U) == 0x40U))
+	{
+		Copy_pxCard -> au8Frame[Copy_pxCard -> u8FrameLength] = Copy_u8Data;
+		Copy_pxCard -> u8FrameLength++;
+		if(Copy_pxCard -> u8FrameLength == 6U)
+		{
+			Copy_pxCard -> u8FrameLength = 0U;
+			MODEL_vCommand(Copy_pxCard);
+		}
+	}
+	else
+	{
+
+	}
+
+	return Loc_u8Out;
+}
+
+/* SPI driver replacement, every byte goes to the card model */
+void SPI_vInit(uint8_t, bool, bool, bool, bool, bool, bool, bool, uint8_t Copy_u8BaudRatePrescaler, bool)
+{
+	Glo_u8BusPrescaler = Copy_u8BaudRatePrescaler;
+}
+
+uint8_t SPI_u8SelectPrescaler(uint32_t Copy_u32PclkHz, uint32_t Copy_u32TargetHz, uint8_t, bool, bool, bool)
+{
+	for(uint8_t Loc_u8BR = SPI_CLOCK_RATE_FREQ_DIVID_BY_2; Loc_u8BR <= SPI_CLOCK_RATE_FREQ_DIVID_BY_256; Loc_u8BR++)
+	{
+		if((Copy_u32PclkHz >> (Loc_u8BR + 1U)) <= Copy_u32TargetHz)
+		{
+			return Loc_u8BR;
+		}
+	}
+
+	return SPI_CLOCK_RATE_INVALID;
+}
+
+void SPI_vTransmitReceive(uint8_t, uint8_t *Copy_pu8TxData, uint8_t *Copy_pu8RxData, uint16_t Copy_u16ElementsNo, bool, uint32_t)
+{
+	for(uint16_t Loc_u16Index = 0U; Loc_u16Index < Copy_u16ElementsNo; Loc_u16Index++)
+	{
+		Copy_pu8RxData[Loc_u16Index] = MODEL_u8Exchange(&Glo_xCard, Copy_pu8TxData[Loc_u16Index]);
+	}
+}
+
+uint8_t SPI_u8GetLastStatus(uint8_t)
+{
+	return SPI_STATUS_OK;
+}
+
+bool SPI_boolAcquire(uint8_t, uint32_t)
+{
+	return true;
+}
+
+void SPI_vRelease(uint8_t)
+{
+}
+
+static void HOST_vSelect(void)
+{
+	Glo_xCard.boolSelected = true;
+}
+
+static void HOST_vDeselect(void)
+{
+	Glo_xCard.boolSelected = false;
+	Glo_xCard.u8FrameLength = 0U;
+	Glo_xCard.xOut.clear();
+}
+
+/**
+ * @fn void HOST_vCheck(bool, const char*)
+ * @brief Print and count one check
+ */
+static void HOST_vCheck(bool Copy_boolPassed, const char* Copy_pcWhat)
+{
+	printf("%s  %s\n", Copy_boolPassed ? "pass" : "FAIL", Copy_pcWhat);
+	if(Copy_boolPassed == false)
+	{
+		Glo_u32Failed++;
+	}
+}
+
+/**
+ * @fn void HOST_vFill(uint8_t*, uint32_t, uint32_t, uint8_t)
+ * @brief Fill a buffer with the pattern of consecutive sectors
+ */
+static void HOST_vFill(uint8_t* Copy_pu8Data, uint32_t Copy_u32Sector, uint32_t Copy_u32Count, uint8_t Copy_u8Seed)
+{
+	for(uint32_t Loc_u32Index = 0U; Loc_u32Index < (Copy_u32Count * SDSPI_BLOCK_SIZE); Loc_u32Index++)
+	{
+		Copy_pu8Data[Loc_u32Index] = MODEL_u8Pattern(Copy_u32Sector + (Loc_u32Index / SDSPI_BLOCK_SIZE), Loc_u32Index % SDSPI_BLOCK_SIZE, Copy_u8Seed);
+	}
+}
+
+/**
+ * @fn bool HOST_boolMatches(const uint8_t*, uint32_t, uint32_t, uint8_t)
+ * @brief Compare a buffer with the pattern of consecutive sectors
+ */
+static bool HOST_boolMatches(const uint8_t* Copy_pu8Data, uint32_t Copy_u32Sector, uint32_t Copy_u32Count, uint8_t Copy_u8Seed)
+{
+	for(uint32_t Loc_u32Index = 0U; Loc_u32Index < (Copy_u32Count * SDSPI_BLOCK_SIZE); Loc_u32Index++)
+	{
+		if(Copy_pu8Data[Loc_u32Index] != MODEL_u8Pattern(Copy_u32Sector + (Loc_u32Index / SDSPI_BLOCK_SIZE), Loc_u32Index % SDSPI_BLOCK_SIZE, Copy_u8Seed))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @fn bool HOST_boolOnCard(uint32_t, uint32_t, uint8_t)
+ * @brief Compare the model memory with the pattern of consecutive sectors
+ */
+static bool HOST_boolOnCard(uint32_t Copy_u32Sector, uint32_t Copy_u32Count, uint8_t Copy_u8Seed)
+{
+	return HOST_boolMatches(&Glo_xCard.xMemory[Copy_u32Sector * SDSPI_BLOCK_SIZE], Copy_u32Sector, Copy_u32Count, Copy_u8Seed);
+}
+
+/**
+ * @fn bool HOST_boolPreErases(const uint32_t*, uint32_t)
+ * @brief Compare the ACMD23 arguments received since the last counter clear
+ */
+static bool HOST_boolPreErases(const uint32_t* Copy_pu32Expected, uint32_t Copy_u32Count)
+{
+	return (Glo_xCard.xPreErases.size() == Copy_u32Count) &&
+		   ((Copy_u32Count == 0U) || (memcmp(&Glo_xCard.xPreErases[0], Copy_pu32Expected, Copy_u32Count * sizeof(uint32_t)) == 0));
+}
+
+/**
+ * @fn void HOST_vInit(bool)
+ * @brief Power on a card and identify it
+ */
+static void HOST_vInit(bool Copy_boolHighCapacity)
+{
+	MODEL_vReset(&Glo_xCard, Copy_boolHighCapacity);
+
+	memset(&Glo_xSD, 0, sizeof(Glo_xSD));
+	Glo_xSD.u8SPIx = SPI1;
+	Glo_xSD.u32PclkHz = 72000000U;
+	Glo_xSD.u32MaxHz = 25000000U;
+	Glo_xSD.pfSelect = HOST_vSelect;
+	Glo_xSD.pfDeselect = HOST_vDeselect;
+
+	HOST_vCheck(SDSPI_u8Init(&Glo_xSD) == SDSPI_OK, "init: card identified");
+	HOST_vCheck(Glo_xSD.u8CardType == (Copy_boolHighCapacity ? SDSPI_CARD_V2_HC : SDSPI_CARD_V2_SC), "init: card type");
+	HOST_vCheck(Glo_xCard.boolIdle == false, "init: card left the idle state");
+	HOST_vCheck(Glo_xCard.boolCrcOn == (SDSPI_CRC_ENABLE != 0U), "init: CMD59 CRC setting");
+	HOST_vCheck(Glo_xCard.au32Commands[16] == (Copy_boolHighCapacity ? 0U : 1U), "init: CMD16 only for byte addressed cards");
+
+	/* Another driver on the bus slows it down, the next access must restore the card prescaler */
+	uint8_t Loc_au8Data[SDSPI_BLOCK_SIZE];
+	SPI_vInit(SPI1, SPI_MODE_MASTER, SPI_DATASIZE_8BIT, SPI_POLARITY_HIGH, SPI_PHASE_2EDGE, SPI_SSM_SW_MANAGE, SPI_SSI_HIGH,
+			SPI_SSOE_OUTPUT_DIS, SPI_CLOCK_RATE_FREQ_DIVID_BY_256, SPI_FIRSTBIT_MSB);
+	SDSPI_u8Read(&Glo_xSD, 0U, Loc_au8Data, 1U);
+	HOST_vCheck((Glo_u8BusPrescaler == Glo_xSD.u8Prescaler) && (Glo_xSD.u8Prescaler == SPI_CLOCK_RATE_FREQ_DIVID_BY_4),
+			"init: card prescaler restored after another driver");
+}
+
+/**
+ * @fn void HOST_vReadAhead(void)
+ * @brief Sequential single sector reads are served by CMD18 read ahead, long reads by one CMD18
+ */
+static void HOST_vReadAhead(void)
+{
+	static uint8_t Loc_au8Data[8U * SDSPI_BLOCK_SIZE];
+	bool Loc_boolData = true;
+
+	MODEL_vClearCounters(&Glo_xCard);
+	for(uint32_t Loc_u32Sector = 0U; Loc_u32Sector < 16U; Loc_u32Sector++)
+	{
+		Loc_boolData &= (SDSPI_u8Read(&Glo_xSD, Loc_u32Sector, Loc_au8Data, 1U) == SDSPI_OK);
+		Loc_boolData &= HOST_boolMatches(Loc_au8Data, Loc_u32Sector, 1U, 0U);
+	}
+	HOST_vCheck(Loc_boolData, "read ahead: 16 sequential sectors read back");
+	HOST_vCheck(Glo_xCard.au32Commands[17] == 1U, "read ahead: first read is a CMD17");
+	HOST_vCheck(Glo_xCard.au32Commands[18] == (16U - 1U + SDSPI_READ_AHEAD_BLOCKS - 1U) / SDSPI_READ_AHEAD_BLOCKS,
+			"read ahead: the others come from CMD18 read ahead");
+	HOST_vCheck(Glo_xCard.au32Commands[12] == Glo_xCard.au32Commands[18], "read ahead: every CMD18 stopped by CMD12");
+
+	MODEL_vClearCounters(&Glo_xCard);
+	HOST_vCheck((SDSPI_u8Read(&Glo_xSD, 40U, Loc_au8Data, 8U) == SDSPI_OK) && HOST_boolMatches(Loc_au8Data, 40U, 8U, 0U),
+			"long read: 8 sectors read back");
+	HOST_vCheck((Glo_xCard.au32Commands[18] == 1U) && (Glo_xCard.au32Commands[17] == 0U), "long read: one CMD18");
+
+	/* Read ahead past the last sector falls back to the requested sector */
+	SDSPI_u8Read(&Glo_xSD, MODEL_SECTORS - 2U, Loc_au8Data, 1U);
+	HOST_vCheck((SDSPI_u8Read(&Glo_xSD, MODEL_SECTORS - 1U, Loc_au8Data, 1U) == SDSPI_OK) &&
+			HOST_boolMatches(Loc_au8Data, MODEL_SECTORS - 1U, 1U, 0U), "read ahead: last sector of the card");
+}
+
+/**
+ * @fn void HOST_vWriteBehind(void)
+ * @brief Sequential single sector writes are queued and sent by ACMD23 + CMD25
+ */
+static void HOST_vWriteBehind(void)
+{
+	static uint8_t Loc_au8Data[16U * SDSPI_BLOCK_SIZE];
+	const uint32_t Loc_au32PreErase[] = {SDSPI_WRITE_BEHIND_BLOCKS, SDSPI_WRITE_BEHIND_BLOCKS, SDSPI_WRITE_BEHIND_BLOCKS, SDSPI_WRITE_BEHIND_BLOCKS};
+	bool Loc_boolOk = true;
+
+	HOST_vFill(Loc_au8Data, 64U, 16U, 1U);
+	MODEL_vClearCounters(&Glo_xCard);
+	for(uint32_t Loc_u32Sector = 0U; Loc_u32Sector < 16U; Loc_u32Sector++)
+	{
+		Loc_boolOk &= (SDSPI_u8Write(&Glo_xSD, 64U + Loc_u32Sector, &Loc_au8Data[Loc_u32Sector * SDSPI_BLOCK_SIZE], 1U) == SDSPI_OK);
+	}
+	HOST_vCheck(Loc_boolOk && (HOST_boolOnCard(64U + 16U - SDSPI_WRITE_BEHIND_BLOCKS, SDSPI_WRITE_BEHIND_BLOCKS, 0U) == true),
+			"write behind: last sectors still queued before sync");
+	HOST_vCheck(SDSPI_u8Sync(&Glo_xSD) == SDSPI_OK, "write behind: sync");
+	HOST_vCheck(HOST_boolOnCard(64U, 16U, 1U), "write behind: 16 sectors on the card");
+	HOST_vCheck((Glo_xCard.au32Commands[25] == (16U / SDSPI_WRITE_BEHIND_BLOCKS)) && (Glo_xCard.au32Commands[24] == 0U),
+			"write behind: multi-block writes only");
+	HOST_vCheck((SDSPI_WRITE_BEHIND_BLOCKS != 4U) || HOST_boolPreErases(Loc_au32PreErase, 4U), "write behind: ACMD23 of the written blocks");
+
+	MODEL_vClearCounters(&Glo_xCard);
+	HOST_vFill(Loc_au8Data, 80U, 8U, 2U);
+	HOST_vCheck((SDSPI_u8Write(&Glo_xSD, 80U, Loc_au8Data, 8U) == SDSPI_OK) && HOST_boolOnCard(80U, 8U, 2U) &&
+			(Glo_xCard.au32Commands[25] == 1U), "long write: straight to the card in one CMD25");
+}
+
+/**
+ * @fn void HOST_vInvalidation(void)
+ * @brief Reads and writes overlapping the caches see the latest data
+ */
+static void HOST_vInvalidation(void)
+{
+	static uint8_t Loc_au8Data[2U * SDSPI_BLOCK_SIZE];
+
+	/* Read ahead holds 101..104 */
+	SDSPI_u8Read(&Glo_xSD, 100U, Loc_au8Data, 1U);
+	SDSPI_u8Read(&Glo_xSD, 101U, Loc_au8Data, 1U);
+
+	HOST_vFill(Loc_au8Data, 103U, 1U, 3U);
+	SDSPI_u8Write(&Glo_xSD, 103U, Loc_au8Data, 1U);
+
+	MODEL_vClearCounters(&Glo_xCard);
+	HOST_vCheck((SDSPI_u8Read(&Glo_xSD, 104U, Loc_au8Data, 1U) == SDSPI_OK) && HOST_boolMatches(Loc_au8Data, 104U, 1U, 0U),
+			"invalidation: sector after the write read back");
+	HOST_vCheck((Glo_xCard.au32Commands[17] + Glo_xCard.au32Commands[18]) == 1U, "invalidation: read ahead dropped by the overlapping write");
+	HOST_vCheck(HOST_boolOnCard(103U, 1U, 0U), "invalidation: written sector still queued");
+
+	MODEL_vClearCounters(&Glo_xCard);
+	HOST_vCheck((SDSPI_u8Read(&Glo_xSD, 102U, Loc_au8Data, 2U) == SDSPI_OK) && HOST_boolMatches(Loc_au8Data, 102U, 1U, 0U) &&
+			HOST_boolMatches(&Loc_au8Data[SDSPI_BLOCK_SIZE], 103U, 1U, 3U), "invalidation: read over the queue");
+	HOST_vCheck(HOST_boolOnCard(103U, 1U, 3U) && (Glo_xCard.au32Commands[24] == 1U), "invalidation: queue flushed before the read");
+	HOST_vCheck((SDSPI_u8Read(&Glo_xSD, 103U, Loc_au8Data, 1U) == SDSPI_OK) && HOST_boolMatches(Loc_au8Data, 103U, 1U, 3U),
+			"invalidation: written data read back");
+
+	/* Write queued first, then a read ahead over it (108..111) */
+	HOST_vFill(Loc_au8Data, 110U, 1U, 3U);
+	SDSPI_u8Write(&Glo_xSD, 110U, Loc_au8Data, 1U);
+	SDSPI_u8Read(&Glo_xSD, 107U, Loc_au8Data, 1U);
+	SDSPI_u8Read(&Glo_xSD, 108U, Loc_au8Data, 1U);
+	HOST_vCheck(HOST_boolOnCard(110U, 1U, 3U), "invalidation: queue flushed before the read ahead over it");
+	HOST_vCheck((SDSPI_u8Read(&Glo_xSD, 110U, Loc_au8Data, 1U) == SDSPI_OK) && HOST_boolMatches(Loc_au8Data, 110U, 1U, 3U),
+			"invalidation: read ahead holds the queued data");
+}
+
+/**
+ * @fn void HOST_vPreErase(void)
+ * @brief The pre-erase hint only extends writes starting inside its area, up to its end
+ */
+static void HOST_vPreErase(void)
+{
+	static uint8_t Loc_au8Data[16U * SDSPI_BLOCK_SIZE];
+	const uint32_t Loc_au32Fat[] = {2U};
+	const uint32_t Loc_au32Area[] = {16U, 12U, 8U, 4U};
+	const uint32_t Loc_au32After[] = {4U};
+	bool Loc_boolOk = true;
+
+	SDSPI_vPreEraseHint(&Glo_xSD, 200U, 16U);
+
+	/* FAT update elsewhere, must not pre-erase the sectors that follow it */
+	MODEL_vClearCounters(&Glo_xCard);
+	HOST_vFill(Loc_au8Data, 10U, 2U, 4U);
+	SDSPI_u8Write(&Glo_xSD, 10U, Loc_au8Data, 1U);
+	SDSPI_u8Write(&Glo_xSD, 11U, &Loc_au8Data[SDSPI_BLOCK_SIZE], 1U);
+	SDSPI_u8Sync(&Glo_xSD);
+	HOST_vCheck(HOST_boolPreErases(Loc_au32Fat, 1U), "pre-erase: write outside the area pre-erases its own blocks");
+	HOST_vCheck(HOST_boolOnCard(10U, 2U, 4U) && HOST_boolOnCard(12U, 14U, 0U), "pre-erase: sectors after the write untouched");
+
+	/* File area written one sector at a time */
+	MODEL_vClearCounters(&Glo_xCard);
+	HOST_vFill(Loc_au8Data, 200U, 16U, 5U);
+	for(uint32_t Loc_u32Sector = 0U; Loc_u32Sector < 16U; Loc_u32Sector++)
+	{
+		Loc_boolOk &= (SDSPI_u8Write(&Glo_xSD, 200U + Loc_u32Sector, &Loc_au8Data[Loc_u32Sector * SDSPI_BLOCK_SIZE], 1U) == SDSPI_OK);
+	}
+	Loc_boolOk &= (SDSPI_u8Sync(&Glo_xSD) == SDSPI_OK);
+	HOST_vCheck(Loc_boolOk && HOST_boolOnCard(200U, 16U, 5U), "pre-erase: area written");
+	HOST_vCheck((SDSPI_WRITE_BEHIND_BLOCKS != 4U) || HOST_boolPreErases(Loc_au32Area, 4U), "pre-erase: ACMD23 up to the end of the area");
+	HOST_vCheck(HOST_boolOnCard(216U, 8U, 0U), "pre-erase: sectors after the area untouched");
+
+	/* Area consumed */
+	MODEL_vClearCounters(&Glo_xCard);
+	HOST_vFill(Loc_au8Data, 230U, 4U, 6U);
+	SDSPI_u8Write(&Glo_xSD, 230U, Loc_au8Data, 4U);
+	HOST_vCheck(HOST_boolPreErases(Loc_au32After, 1U) && HOST_boolOnCard(230U, 4U, 6U), "pre-erase: hint used up");
+
+	/* Abandoned area: the model loses the pre-erased blocks that were not written, as a real card may */
+	SDSPI_vPreEraseHint(&Glo_xSD, 240U, 8U);
+	HOST_vFill(Loc_au8Data, 240U, 4U, 7U);
+	SDSPI_u8Write(&Glo_xSD, 240U, Loc_au8Data, 4U);
+	HOST_vCheck(HOST_boolOnCard(240U, 4U, 7U) && (Glo_xCard.xMemory[244U * SDSPI_BLOCK_SIZE] == MODEL_ERASED_BYTE),
+			"pre-erase: unwritten part of the area erased by the model");
+	SDSPI_vPreEraseHint(&Glo_xSD, 0U, 0U);
+}
+
+/**
+ * @fn void HOST_vCrc(void)
+ * @brief A corrupted data block is reported when the CRC is checked
+ */
+static void HOST_vCrc(void)
+{
+	static uint8_t Loc_au8Data[SDSPI_BLOCK_SIZE];
+
+	Glo_xCard.boolCorruptCrc = true;
+#if SDSPI_CRC_ENABLE
+	HOST_vCheck(SDSPI_u8Read(&Glo_xSD, 150U, Loc_au8Data, 1U) == SDSPI_ERR_CRC, "crc: corrupted block rejected");
+#else
+	HOST_vCheck(SDSPI_u8Read(&Glo_xSD, 150U, Loc_au8Data, 1U) == SDSPI_OK, "crc: block CRC not checked");
+#endif
+	HOST_vCheck((SDSPI_u8Read(&Glo_xSD, 150U, Loc_au8Data, 1U) == SDSPI_OK) && HOST_boolMatches(Loc_au8Data, 150U, 1U, 0U),
+			"crc: next read of the block");
+}
+
+int main(void)
+{
+	const bool Loc_aboolHighCapacity[] = {true, false};
+
+	for(uint8_t Loc_u8Run = 0U; Loc_u8Run < 2U; Loc_u8Run++)
+	{
+		printf("-- %s card, CRC %s\n", Loc_aboolHighCapacity[Loc_u8Run] ? "high capacity" : "standard capacity",
+				SDSPI_CRC_ENABLE ? "on" : "off");
+
+		HOST_vInit(Loc_aboolHighCapacity[Loc_u8Run]);
+		HOST_vReadAhead();
+		HOST_vWriteBehind();
+		HOST_vInvalidation();
+		HOST_vPreErase();
+		HOST_vCrc();
+	}
+
+	printf("%u check(s) failed\n", Glo_u32Failed);
+
+	return (int)Glo_u32Failed;
+}
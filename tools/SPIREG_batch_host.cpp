@@ -0,0 +1,375 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+/************************************************************************************
+ * Host register device model and SPIREG batch checks.								*
+ *																					*
+ * Build:	g++ -std=c++11 -O2 -Itools/host/inc -o SPIREG_batch_host				*
+ *				tools/SPIREG_batch_host.cpp SPIREG_module.cpp						*
+ * Usage:	SPIREG_batch_host														*
+ *																					*
+ * The SPI driver is replaced by a model of a register based sensor: the first		*
+ * byte of a chip select window is the address (bit 7 read, MODEL_INC_BIT asks		*
+ * for auto-increment), the next bytes read or write consecutive registers.			*
+ * Register MODEL_FIFO_REG returns a new value on every read, like a FIFO.			*
+ * Every window is recorded to check how the batches were merged and split.			*
+ * The exit code is the number of failed checks.									*
+ ***********************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "../SPI_interface.h"
+#include "../SPIREG_interface.h"
+
+#define MODEL_REGISTERS			0x40U
+#define MODEL_READ_BIT			0x80U
+#define MODEL_INC_BIT			0x40U
+#define MODEL_FIFO_REG			0x3AU
+
+/* Register device seen one chip select window at a time */
+typedef struct
+{
+	uint8_t								au8Registers[MODEL_REGISTERS];
+	uint8_t								u8FifoNext;			/* Value of the next FIFO read						*/
+	uint32_t							u32Selects;			/* Chip select windows opened by pfSelect			*/
+	std::vector<std::vector<uint8_t> >	xWindows;			/* MOSI bytes of every window						*/
+	std::vector<uint16_t>				xWrites;			/* Register writes in order, address << 8 | value	*/
+}MODEL_Device_t;
+
+static MODEL_Device_t Glo_xDevice;
+static uint32_t Glo_u32Failed = 0U;
+
+/**
+ * @fn void MODEL_vReset(void)
+ * @brief Register n holds 0xA0 + n, the FIFO restarts at 1, the recordings are cleared
+ */
+static void MODEL_vReset(void)
+{
+	for(uint8_t Loc_u8Reg = 0U; Loc_u8Reg < MODEL_REGISTERS; Loc_u8Reg++)
+	{
+		Glo_xDevice.au8Registers[Loc_u8Reg] = (uint8_t)(0xA0U + Loc_u8Reg);
+	}
+	Glo_xDevice.u8FifoNext = 1U;
+	Glo_xDevice.u32Selects = 0U;
+	Glo_xDevice.xWindows.clear();
+	Glo_xDevice.xWrites.clear();
+}
+
+/**
+ * @fn void MODEL_vWindow(uint8_t*, uint16_t)
+ * @brief One chip select window, the frame is replaced in place by the bytes the device sends
+ */
+static void MODEL_vWindow(uint8_t* Copy_pu8Frame, uint16_t Copy_u16Length)
+{
+	uint8_t Loc_u8Command = Copy_pu8Frame[0];
+	uint8_t Loc_u8Address = Loc_u8Command & (uint8_t)~(MODEL_READ_BIT | MODEL_INC_BIT);
+	bool Loc_boolRead = ((Loc_u8Command & MODEL_READ_BIT) != 0U);
+	bool Loc_boolIncrement = ((Loc_u8Command & MODEL_INC_BIT) != 0U);
+
+	Glo_xDevice.xWindows.push_back(std::vector<uint8_t>(Copy_pu8Frame, Copy_pu8Frame + Copy_u16Length));
+
+	Copy_pu8Frame[0] = 0xFFU;
+	for(uint16_t Loc_u16Byte = 1U; Loc_u16Byte < Copy_u16Length; Loc_u16Byte++)
+	{
+		if(Loc_boolRead == true)
+		{
+			if(Loc_u8Address == MODEL_FIFO_REG)
+			{
+				Copy_pu8Frame[Loc_u16Byte] = Glo_xDevice.u8FifoNext;
+				Glo_xDevice.u8FifoNext++;
+			}
+			else
+			{
+				Copy_pu8Frame[Loc_u16Byte] = Glo_xDevice.au8Registers[Loc_u8Address % MODEL_REGISTERS];
+			}
+		}
+		else
+		{
+			Glo_xDevice.au8Registers[Loc_u8Address % MODEL_REGISTERS] = Copy_pu8Frame[Loc_u16Byte];
+			Glo_xDevice.xWrites.push_back((uint16_t)((Loc_u8Address << 8) | Copy_pu8Frame[Loc_u16Byte]));
+			Copy_pu8Frame[Loc_u16Byte] = 0xFFU;
+		}
+
+		/* Without the increment bit the device keeps accessing the same register */
+		if(Loc_boolIncrement == true)
+		{
+			Loc_u8Address++;
+		}
+	}
+}
+
+/* SPI driver replacement, every transfer is one window of the device model */
+void SPI_vTransmitReceive(uint8_t, uint8_t *Copy_pu8TxData, uint8_t *Copy_pu8RxData, uint16_t Copy_u16ElementsNo, bool, uint32_t)
+{
+	if(Copy_pu8TxData != Copy_pu8RxData)
+	{
+		memcpy(Copy_pu8RxData, Copy_pu8TxData, Copy_u16ElementsNo);
+	}
+	MODEL_vWindow(Copy_pu8RxData, Copy_u16ElementsNo);
+}
+
+uint8_t SPI_u8GetLastStatus(uint8_t)
+{
+	return SPI_STATUS_OK;
+}
+
+bool SPI_boolAcquire(uint8_t, uint32_t)
+{
+	return true;
+}
+
+void SPI_vRelease(uint8_t)
+{
+}
+
+static void HOST_vSelect(void)
+{
+	Glo_xDevice.u32Selects++;
+}
+
+static void HOST_vDeselect(void)
+{
+}
+
+/* Device with auto-increment and no gap allowed (FIFO registers) */
+static const SPIREG_Device_t Glo_xBurstDevice =
+{
+	SPI1, MODEL_READ_BIT, 0x00U, MODEL_INC_BIT, true, 0U, 1000U, HOST_vSelect, HOST_vDeselect
+};
+
+/**
+ * @fn void HOST_vCheck(bool, const char*)
+ * @brief Print and count one check
+ *
+ * @retval None
+ */
+static void HOST_vCheck(bool Copy_boolPassed, const char* Copy_pcWhat)
+{
+	printf("%s  %s\n", Copy_boolPassed ? "pass" : "FAIL", Copy_pcWhat);
+	if(Copy_boolPassed == false)
+	{
+		Glo_u32Failed++;
+	}
+}
+
+/**
+ * @fn bool HOST_boolWindow(uint32_t, uint8_t, uint16_t)
+ * @brief Check the address byte and the length (address byte included) of a recorded window
+ */
+static bool HOST_boolWindow(uint32_t Copy_u32Window, uint8_t Copy_u8Command, uint16_t Copy_u16Length)
+{
+	return (Copy_u32Window < Glo_xDevice.xWindows.size()) &&
+		   (Glo_xDevice.xWindows[Copy_u32Window][0] == Copy_u8Command) &&
+		   (Glo_xDevice.xWindows[Copy_u32Window].size() == Copy_u16Length);
+}
+
+/**
+ * @fn bool HOST_boolRegisters(const uint8_t*, uint8_t, uint8_t)
+ * @brief Check data read from untouched registers
+ */
+static bool HOST_boolRegisters(const uint8_t* Copy_pu8Data, uint8_t Copy_u8Address, uint8_t Copy_u8Length)
+{
+	for(uint8_t Loc_u8Reg = 0U; Loc_u8Reg < Copy_u8Length; Loc_u8Reg++)
+	{
+		if(Copy_pu8Data[Loc_u8Reg] != (uint8_t)(0xA0U + Copy_u8Address + Loc_u8Reg))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @fn void HOST_vMerge(void)
+ * @brief Adjacent reads share one burst in address order, the data is scattered back to each read
+ */
+static void HOST_vMerge(void)
+{
+	uint8_t Loc_au8A[2], Loc_au8B[4], Loc_au8C[1];
+	const SPIREG_Op_t Loc_axOps[] =
+	{
+		{0x12U, SPIREG_READ, 4U, Loc_au8B},
+		{0x10U, SPIREG_READ, 2U, Loc_au8A},
+		{0x16U, SPIREG_READ, 1U, Loc_au8C},
+	};
+
+	MODEL_vReset();
+	HOST_vCheck(SPIREG_u8Batch(&Glo_xBurstDevice, Loc_axOps, 3U) == SPI_STATUS_OK, "merge: batch done");
+	HOST_vCheck((Glo_xDevice.xWindows.size() == 1U) && HOST_boolWindow(0U, 0x10U | MODEL_READ_BIT | MODEL_INC_BIT, 8U),
+			"merge: one burst from the lowest address");
+	HOST_vCheck(HOST_boolRegisters(Loc_au8A, 0x10U, 2U) && HOST_boolRegisters(Loc_au8B, 0x12U, 4U) && HOST_boolRegisters(Loc_au8C, 0x16U, 1U),
+			"merge: data scattered to every read");
+	HOST_vCheck(Glo_xDevice.u32Selects == 1U, "merge: one chip select window");
+
+	/* A single register is read without the increment bit */
+	MODEL_vReset();
+	SPIREG_u8Read(&Glo_xBurstDevice, 0x05U, Loc_au8C, 1U);
+	HOST_vCheck(HOST_boolWindow(0U, 0x05U | MODEL_READ_BIT, 2U) && HOST_boolRegisters(Loc_au8C, 0x05U, 1U), "merge: single register read");
+}
+
+/**
+ * @fn void HOST_vGap(void)
+ * @brief Holes up to u8MaxGap registers are read and dropped, larger holes split the burst
+ */
+static void HOST_vGap(void)
+{
+	SPIREG_Device_t Loc_xDevice = Glo_xBurstDevice;
+	uint8_t Loc_au8A[1], Loc_au8B[1];
+	const SPIREG_Op_t Loc_axNear[] = {{0x10U, SPIREG_READ, 1U, Loc_au8A}, {0x13U, SPIREG_READ, 1U, Loc_au8B}};
+	const SPIREG_Op_t Loc_axFar[] = {{0x10U, SPIREG_READ, 1U, Loc_au8A}, {0x14U, SPIREG_READ, 1U, Loc_au8B}};
+
+	Loc_xDevice.u8MaxGap = 2U;
+
+	MODEL_vReset();
+	SPIREG_u8Batch(&Loc_xDevice, Loc_axNear, 2U);
+	HOST_vCheck((Glo_xDevice.xWindows.size() == 1U) && HOST_boolWindow(0U, 0x10U | MODEL_READ_BIT | MODEL_INC_BIT, 5U) &&
+			HOST_boolRegisters(Loc_au8A, 0x10U, 1U) && HOST_boolRegisters(Loc_au8B, 0x13U, 1U), "gap: hole of 2 read through");
+
+	MODEL_vReset();
+	SPIREG_u8Batch(&Loc_xDevice, Loc_axFar, 2U);
+	HOST_vCheck((Glo_xDevice.xWindows.size() == 2U) && HOST_boolRegisters(Loc_au8A, 0x10U, 1U) && HOST_boolRegisters(Loc_au8B, 0x14U, 1U),
+			"gap: hole of 3 splits the burst");
+
+	MODEL_vReset();
+	SPIREG_u8Batch(&Glo_xBurstDevice, Loc_axNear, 2U);
+	HOST_vCheck(Glo_xDevice.xWindows.size() == 2U, "gap: no hole read when u8MaxGap is 0");
+}
+
+/**
+ * @fn void HOST_vFifo(void)
+ * @brief Repeated and overlapping reads are never merged, every FIFO read reaches the device
+ */
+static void HOST_vFifo(void)
+{
+	SPIREG_Device_t Loc_xDevice = Glo_xBurstDevice;
+	uint8_t Loc_u8A = 0U, Loc_u8B = 0U, Loc_u8C = 0U;
+	uint8_t Loc_au8A[4], Loc_au8B[4];
+	const SPIREG_Op_t Loc_axFifo[] =
+	{
+		{MODEL_FIFO_REG, SPIREG_READ, 1U, &Loc_u8A},
+		{MODEL_FIFO_REG, SPIREG_READ, 1U, &Loc_u8B},
+		{MODEL_FIFO_REG, SPIREG_READ, 1U, &Loc_u8C},
+	};
+	const SPIREG_Op_t Loc_axOverlap[] = {{0x10U, SPIREG_READ, 4U, Loc_au8A}, {0x12U, SPIREG_READ, 4U, Loc_au8B}};
+
+	MODEL_vReset();
+	SPIREG_u8Batch(&Glo_xBurstDevice, Loc_axFifo, 3U);
+	HOST_vCheck(Glo_xDevice.xWindows.size() == 3U, "fifo: one window per read of the same register");
+	HOST_vCheck((Loc_u8A == 1U) && (Loc_u8B == 2U) && (Loc_u8C == 3U), "fifo: every entry popped once, in batch order");
+
+	Loc_xDevice.u8MaxGap = 4U;
+	MODEL_vReset();
+	SPIREG_u8Batch(&Loc_xDevice, Loc_axOverlap, 2U);
+	HOST_vCheck((Glo_xDevice.xWindows.size() == 2U) && HOST_boolRegisters(Loc_au8A, 0x10U, 4U) && HOST_boolRegisters(Loc_au8B, 0x12U, 4U),
+			"fifo: overlapping reads not merged");
+}
+
+/**
+ * @fn void HOST_vBurstMax(void)
+ * @brief Bursts never exceed SPIREG_BURST_MAX registers
+ */
+static void HOST_vBurstMax(void)
+{
+	static uint8_t Loc_au8A[SPIREG_BURST_MAX], Loc_au8B[SPIREG_BURST_MAX];
+	const SPIREG_Op_t Loc_axOps[] =
+	{
+		{0x00U, SPIREG_READ, (uint8_t)(SPIREG_BURST_MAX - 4U), Loc_au8A},
+		{(uint8_t)(SPIREG_BURST_MAX - 4U), SPIREG_READ, 8U, Loc_au8B},
+	};
+	const SPIREG_Op_t Loc_axTooLong[] = {{0x00U, SPIREG_READ, (uint8_t)(SPIREG_BURST_MAX + 1U), Loc_au8A}};
+	const SPIREG_Op_t Loc_axEmpty[] = {{0x00U, SPIREG_READ, 0U, Loc_au8A}};
+
+	MODEL_vReset();
+	SPIREG_u8Read(&Glo_xBurstDevice, 0x00U, Loc_au8A, SPIREG_BURST_MAX);
+	HOST_vCheck((Glo_xDevice.xWindows.size() == 1U) && HOST_boolWindow(0U, MODEL_READ_BIT | MODEL_INC_BIT, SPIREG_BURST_MAX + 1U) &&
+			HOST_boolRegisters(Loc_au8A, 0x00U, SPIREG_BURST_MAX), "burst max: full burst in one window");
+
+	MODEL_vReset();
+	SPIREG_u8Batch(&Glo_xBurstDevice, Loc_axOps, 2U);
+	HOST_vCheck((Glo_xDevice.xWindows.size() == 2U) && HOST_boolWindow(0U, MODEL_READ_BIT | MODEL_INC_BIT, SPIREG_BURST_MAX - 4U + 1U) &&
+			HOST_boolRegisters(Loc_au8A, 0x00U, SPIREG_BURST_MAX - 4U) && HOST_boolRegisters(Loc_au8B, SPIREG_BURST_MAX - 4U, 8U),
+			"burst max: adjacent reads split at the limit");
+
+	MODEL_vReset();
+	HOST_vCheck((SPIREG_u8Batch(&Glo_xBurstDevice, Loc_axTooLong, 1U) == SPIREG_STATUS_INVALID) &&
+			(SPIREG_u8Batch(&Glo_xBurstDevice, Loc_axEmpty, 1U) == SPIREG_STATUS_INVALID) && Glo_xDevice.xWindows.empty(),
+			"burst max: invalid lengths rejected before any window");
+}
+
+/**
+ * @fn void HOST_vNoIncrement(void)
+ * @brief Devices without auto-increment get one window per register
+ */
+static void HOST_vNoIncrement(void)
+{
+	SPIREG_Device_t Loc_xDevice = Glo_xBurstDevice;
+	uint8_t Loc_au8Read[3], Loc_au8Other[1];
+	uint8_t Loc_au8Write[2] = {0x11U, 0x22U};
+	const SPIREG_Op_t Loc_axOps[] =
+	{
+		{0x10U, SPIREG_READ, 3U, Loc_au8Read},
+		{0x13U, SPIREG_READ, 1U, Loc_au8Other},
+		{0x20U, SPIREG_WRITE, 2U, Loc_au8Write},
+	};
+
+	Loc_xDevice.boolAutoIncrement = false;
+	Loc_xDevice.u8MaxGap = 4U;
+
+	MODEL_vReset();
+	SPIREG_u8Batch(&Loc_xDevice, Loc_axOps, 3U);
+	HOST_vCheck((Glo_xDevice.xWindows.size() == 6U) &&
+			HOST_boolWindow(0U, 0x10U | MODEL_READ_BIT, 2U) && HOST_boolWindow(1U, 0x11U | MODEL_READ_BIT, 2U) &&
+			HOST_boolWindow(2U, 0x12U | MODEL_READ_BIT, 2U) && HOST_boolWindow(3U, 0x13U | MODEL_READ_BIT, 2U) &&
+			HOST_boolWindow(4U, 0x20U, 2U) && HOST_boolWindow(5U, 0x21U, 2U), "no increment: one window per register");
+	HOST_vCheck(HOST_boolRegisters(Loc_au8Read, 0x10U, 3U) && HOST_boolRegisters(Loc_au8Other, 0x13U, 1U) &&
+			(Glo_xDevice.au8Registers[0x20] == 0x11U) && (Glo_xDevice.au8Registers[0x21] == 0x22U), "no increment: data");
+}
+
+/**
+ * @fn void HOST_vWriteOrder(void)
+ * @brief Writes keep their order, only writes continuing the burst are merged, reads see earlier writes
+ */
+static void HOST_vWriteOrder(void)
+{
+	uint8_t Loc_u8A = 0x01U, Loc_u8B = 0x02U, Loc_u8C = 0x03U, Loc_u8D = 0x04U;
+	uint8_t Loc_u8Read = 0U, Loc_u8Before = 0U;
+	const SPIREG_Op_t Loc_axOps[] =
+	{
+		{0x31U, SPIREG_READ, 1U, &Loc_u8Before},
+		{0x30U, SPIREG_WRITE, 1U, &Loc_u8A},
+		{0x31U, SPIREG_WRITE, 1U, &Loc_u8B},
+		{0x30U, SPIREG_WRITE, 1U, &Loc_u8C},
+		{0x31U, SPIREG_READ, 1U, &Loc_u8Read},
+		{0x31U, SPIREG_WRITE, 1U, &Loc_u8D},
+	};
+	const uint16_t Loc_au16Writes[] = {0x3001U, 0x3102U, 0x3003U, 0x3104U};
+
+	MODEL_vReset();
+	HOST_vCheck(SPIREG_u8Batch(&Glo_xBurstDevice, Loc_axOps, 6U) == SPI_STATUS_OK, "write order: batch done");
+	HOST_vCheck((Glo_xDevice.xWindows.size() == 5U) && HOST_boolWindow(1U, 0x30U | MODEL_INC_BIT, 3U) && HOST_boolWindow(2U, 0x30U, 2U),
+			"write order: adjacent writes merged, a step back starts a new burst");
+	HOST_vCheck((Glo_xDevice.xWrites.size() == 4U) && (memcmp(&Glo_xDevice.xWrites[0], Loc_au16Writes, sizeof(Loc_au16Writes)) == 0),
+			"write order: registers written in batch order");
+	HOST_vCheck((Loc_u8Before == 0xD1U) && (Loc_u8Read == 0x02U), "write order: reads placed between the writes");
+	HOST_vCheck((Glo_xDevice.au8Registers[0x30] == 0x03U) && (Glo_xDevice.au8Registers[0x31] == 0x04U), "write order: last write wins");
+}
+
+int main(void)
+{
+	HOST_vMerge();
+	HOST_vGap();
+	HOST_vFifo();
+	HOST_vBurstMax();
+	HOST_vNoIncrement();
+	HOST_vWriteOrder();
+
+	printf("%u check(s) failed\n", Glo_u32Failed);
+
+	return (int)Glo_u32Failed;
+}
@@ -0,0 +1,327 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+/************************************************************************************
+ * Host pthread implementation of SPI_Port_t and bus lock checks.					*
+ *																					*
+ * Build:	g++ -std=c++11 -O2 -pthread -Itools/host/inc -o SPI_port_host			*
+ *				tools/SPI_port_host.cpp SPI_module.cpp								*
+ * Usage:	SPI_port_host															*
+ *																					*
+ * Every thread is a task with a simulated priority (the value the driver reads		*
+ * and writes through the port hooks), the critical section is a mutex.				*
+ * Only the bus lock and the lock timeout path of SPI_vTransmit are used, the		*
+ * registers are never accessed.													*
+ * The exit code is the number of failed checks.									*
+ ***********************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <atomic>
+#include "../SPI_interface.h"
+
+#define HOST_WAIT_US			1000000U	/* Bound of every wait of the checks				*/
+#define HOST_SHORT_TIMEOUT_US	2000U
+
+/* Simulated task */
+typedef struct
+{
+	std::atomic<uint8_t>	u8Priority;
+}HOST_Task_t;
+
+/* Bus lock attempt made by a helper thread */
+typedef struct
+{
+	HOST_Task_t*			pxTask;
+	uint8_t					u8SPIx;
+	uint32_t				u32Timeout;
+	uint64_t				u64ElapsedUs;
+	std::atomic<bool>		boolAcquired;
+	uint8_t					u8Status;			/* Last status seen by the helper after a transfer attempt	*/
+}HOST_Attempt_t;
+
+static pthread_mutex_t Glo_xCritical = PTHREAD_MUTEX_INITIALIZER;
+static thread_local HOST_Task_t* Glo_pxSelf = nullptr;
+static uint32_t Glo_u32Failed = 0U;
+
+uint64_t micros(void)
+{
+	struct timespec Loc_xNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &Loc_xNow);
+	return ((uint64_t)Loc_xNow.tv_sec * 1000000U) + ((uint64_t)Loc_xNow.tv_nsec / 1000U);
+}
+
+static void* HOST_pvGetCurrentTask(void)
+{
+	return Glo_pxSelf;
+}
+
+static uint8_t HOST_u8GetTaskPriority(void* Copy_pvTask)
+{
+	return ((HOST_Task_t*)Copy_pvTask) -> u8Priority;
+}
+
+static void HOST_vSetTaskPriority(void* Copy_pvTask, uint8_t Copy_u8Priority)
+{
+	((HOST_Task_t*)Copy_pvTask) -> u8Priority = Copy_u8Priority;
+}
+
+static void HOST_vEnterCritical(void)
+{
+	pthread_mutex_lock(&Glo_xCritical);
+}
+
+static void HOST_vExitCritical(void)
+{
+	pthread_mutex_unlock(&Glo_xCritical);
+}
+
+static void HOST_vYield(void)
+{
+	sched_yield();
+}
+
+static void HOST_vSleepUs(uint32_t Copy_u32Us)
+{
+	usleep(Copy_u32Us);
+}
+
+static const SPI_Port_t Glo_xPort =
+{
+	HOST_pvGetCurrentTask, HOST_u8GetTaskPriority, HOST_vSetTaskPriority,
+	HOST_vEnterCritical, HOST_vExitCritical, HOST_vYield, HOST_vSleepUs, 100U
+};
+
+/**
+ * @fn void HOST_vCheck(bool, const char*)
+ * @brief Print and count one check
+ *
+ * @retval None
+ */
+static void HOST_vCheck(bool Copy_boolPassed, const char* Copy_pcWhat)
+{
+	printf("%s  %s\n", Copy_boolPassed ? "pass" : "FAIL", Copy_pcWhat);
+	if(Copy_boolPassed == false)
+	{
+		Glo_u32Failed++;
+	}
+}
+
+/**
+ * @fn bool HOST_boolWaitPriority(HOST_Task_t*, uint8_t)
+ * @brief Wait until a task priority reaches a value, the waiter boosts the owner asynchronously
+ *
+ * @retval true if the value was reached before HOST_WAIT_US
+ */
+static bool HOST_boolWaitPriority(HOST_Task_t* Copy_pxTask, uint8_t Copy_u8Priority)
+{
+	uint64_t Loc_u64Start = micros();
+
+	while((Copy_pxTask -> u8Priority != Copy_u8Priority) && ((micros() - Loc_u64Start) < HOST_WAIT_US))
+	{
+		usleep(50U);
+	}
+
+	return (Copy_pxTask -> u8Priority == Copy_u8Priority);
+}
+
+/**
+ * @fn void* HOST_pvAttempt(void*)
+ * @brief Helper thread body, takes a bus lock and releases it at once
+ *
+ * @retval nullptr
+ */
+static void* HOST_pvAttempt(void* Copy_pvAttempt)
+{
+	HOST_Attempt_t* Loc_pxAttempt = (HOST_Attempt_t*)Copy_pvAttempt;
+	uint64_t Loc_u64Start = micros();
+	bool Loc_boolAcquired;
+
+	Glo_pxSelf = Loc_pxAttempt -> pxTask;
+	Loc_boolAcquired = SPI_boolAcquire(Loc_pxAttempt -> u8SPIx, Loc_pxAttempt -> u32Timeout);
+	Loc_pxAttempt -> u64ElapsedUs = micros() - Loc_u64Start;
+	if(Loc_boolAcquired == true)
+	{
+		SPI_vRelease(Loc_pxAttempt -> u8SPIx);
+	}
+	Loc_pxAttempt -> boolAcquired = Loc_boolAcquired;
+
+	return nullptr;
+}
+
+/**
+ * @fn void HOST_vAttempt(HOST_Attempt_t*, HOST_Task_t*, uint8_t, uint32_t, pthread_t*)
+ * @brief Start a helper thread taking a bus lock
+ *
+ * @retval None
+ */
+static void HOST_vAttempt(HOST_Attempt_t* Copy_pxAttempt, HOST_Task_t* Copy_pxTask, uint8_t Copy_u8SPIx, uint32_t Copy_u32Timeout,
+		pthread_t* Copy_pxThread)
+{
+	Copy_pxAttempt -> pxTask = Copy_pxTask;
+	Copy_pxAttempt -> u8SPIx = Copy_u8SPIx;
+	Copy_pxAttempt -> u32Timeout = Copy_u32Timeout;
+	Copy_pxAttempt -> u64ElapsedUs = 0U;
+	Copy_pxAttempt -> boolAcquired = false;
+	pthread_create(Copy_pxThread, nullptr, HOST_pvAttempt, Copy_pxAttempt);
+}
+
+/**
+ * @fn void* HOST_pvTransmit(void*)
+ * @brief Helper thread body, a blocking transfer on a bus owned by another task, it gives up with SPI_STATUS_BUSY
+ * before touching the peripheral
+ *
+ * @retval nullptr
+ */
+static void* HOST_pvTransmit(void* Copy_pvAttempt)
+{
+	HOST_Attempt_t* Loc_pxAttempt = (HOST_Attempt_t*)Copy_pvAttempt;
+	uint8_t Loc_u8Data = 0x55U;
+
+	Glo_pxSelf = Loc_pxAttempt -> pxTask;
+	SPI_vTransmit(Loc_pxAttempt -> u8SPIx, &Loc_u8Data, 1U, SPI_DATASIZE_8BIT, Loc_pxAttempt -> u32Timeout);
+	Loc_pxAttempt -> u8Status = SPI_u8GetLastStatus(Loc_pxAttempt -> u8SPIx);
+
+	return nullptr;
+}
+
+/**
+ * @fn void HOST_vRecursionAndTimeout(HOST_Task_t*, HOST_Task_t*)
+ * @brief A recursive lock stays owned until every level is released, a contender times out meanwhile
+ *
+ * @retval None
+ */
+static void HOST_vRecursionAndTimeout(HOST_Task_t* Copy_pxOwner, HOST_Task_t* Copy_pxOther)
+{
+	HOST_Attempt_t Loc_xAttempt;
+	pthread_t Loc_xThread;
+
+	HOST_vCheck(SPI_boolAcquire(SPI3, 0U) == true, "recursion: first level taken");
+	HOST_vCheck(SPI_boolAcquire(SPI3, 0U) == true, "recursion: second level taken by the owner without waiting");
+	SPI_vRelease(SPI3);
+
+	HOST_vAttempt(&Loc_xAttempt, Copy_pxOther, SPI3, HOST_SHORT_TIMEOUT_US, &Loc_xThread);
+	pthread_join(Loc_xThread, nullptr);
+	HOST_vCheck(Loc_xAttempt.boolAcquired == false, "recursion: lock still owned after one release");
+	HOST_vCheck(Loc_xAttempt.u64ElapsedUs >= HOST_SHORT_TIMEOUT_US, "timeout: contender waited the whole timeout");
+	HOST_vCheck(Loc_xAttempt.u64ElapsedUs < HOST_WAIT_US, "timeout: contender gave up");
+
+	SPI_vRelease(SPI3);
+
+	HOST_vAttempt(&Loc_xAttempt, Copy_pxOther, SPI3, HOST_SHORT_TIMEOUT_US, &Loc_xThread);
+	pthread_join(Loc_xThread, nullptr);
+	HOST_vCheck(Loc_xAttempt.boolAcquired == true, "recursion: lock free after the last release");
+	HOST_vCheck(Copy_pxOwner -> u8Priority == 1U, "recursion: owner priority untouched");
+}
+
+/**
+ * @fn void HOST_vInheritance(HOST_Task_t*, HOST_Task_t*)
+ * @brief A higher priority waiter boosts the owner until the lock is released
+ *
+ * @retval None
+ */
+static void HOST_vInheritance(HOST_Task_t* Copy_pxOwner, HOST_Task_t* Copy_pxHigh)
+{
+	HOST_Attempt_t Loc_xAttempt;
+	pthread_t Loc_xThread;
+
+	SPI_boolAcquire(SPI1, 0U);
+	HOST_vAttempt(&Loc_xAttempt, Copy_pxHigh, SPI1, HOST_WAIT_US, &Loc_xThread);
+	HOST_vCheck(HOST_boolWaitPriority(Copy_pxOwner, Copy_pxHigh -> u8Priority), "inheritance: owner raised to the waiter priority");
+
+	SPI_vRelease(SPI1);
+	HOST_vCheck(Copy_pxOwner -> u8Priority == 1U, "inheritance: owner priority restored on release");
+	pthread_join(Loc_xThread, nullptr);
+	HOST_vCheck(Loc_xAttempt.boolAcquired == true, "inheritance: waiter got the lock");
+}
+
+/**
+ * @fn void HOST_vInheritanceSeveralLocks(HOST_Task_t*, HOST_Task_t*, HOST_Task_t*)
+ * @brief The owner of two locks (striped bus) keeps the inherited priority until its last lock is released
+ *
+ * @retval None
+ */
+static void HOST_vInheritanceSeveralLocks(HOST_Task_t* Copy_pxOwner, HOST_Task_t* Copy_pxMid, HOST_Task_t* Copy_pxHigh)
+{
+	HOST_Attempt_t Loc_xAttempt1, Loc_xAttempt2;
+	pthread_t Loc_xThread1, Loc_xThread2;
+
+	SPI_boolAcquire(SPI1, 0U);
+	HOST_vAttempt(&Loc_xAttempt1, Copy_pxMid, SPI1, HOST_WAIT_US, &Loc_xThread1);
+	HOST_vCheck(HOST_boolWaitPriority(Copy_pxOwner, Copy_pxMid -> u8Priority), "several locks: owner raised by the SPI1 waiter");
+
+	/* The boosted priority must not be taken as the base priority of the 2nd lock */
+	SPI_boolAcquire(SPI2, 0U);
+	HOST_vAttempt(&Loc_xAttempt2, Copy_pxHigh, SPI2, HOST_WAIT_US, &Loc_xThread2);
+	HOST_vCheck(HOST_boolWaitPriority(Copy_pxOwner, Copy_pxHigh -> u8Priority), "several locks: owner raised by the SPI2 waiter");
+
+	SPI_vRelease(SPI1);
+	HOST_vCheck(Copy_pxOwner -> u8Priority == Copy_pxHigh -> u8Priority, "several locks: priority kept while SPI2 is held");
+	pthread_join(Loc_xThread1, nullptr);
+	HOST_vCheck(Loc_xAttempt1.boolAcquired == true, "several locks: SPI1 waiter got the lock");
+
+	SPI_vRelease(SPI2);
+	HOST_vCheck(Copy_pxOwner -> u8Priority == 1U, "several locks: original priority restored after the last lock");
+	pthread_join(Loc_xThread2, nullptr);
+	HOST_vCheck(Loc_xAttempt2.boolAcquired == true, "several locks: SPI2 waiter got the lock");
+
+	/* No stale state left behind */
+	SPI_boolAcquire(SPI2, 0U);
+	SPI_vRelease(SPI2);
+	HOST_vCheck(Copy_pxOwner -> u8Priority == 1U, "several locks: priority unchanged by a later lock");
+}
+
+/**
+ * @fn void HOST_vStatus(HOST_Task_t*)
+ * @brief A task failing to take the bus does not change the last status seen by the owner
+ *
+ * @retval None
+ */
+static void HOST_vStatus(HOST_Task_t* Copy_pxOther)
+{
+	HOST_Attempt_t Loc_xAttempt;
+	pthread_t Loc_xThread;
+
+	SPI_boolAcquire(SPI2, 0U);
+
+	Loc_xAttempt.pxTask = Copy_pxOther;
+	Loc_xAttempt.u8SPIx = SPI2;
+	Loc_xAttempt.u32Timeout = HOST_SHORT_TIMEOUT_US;
+	Loc_xAttempt.u8Status = SPI_STATUS_OK;
+	pthread_create(&Loc_xThread, nullptr, HOST_pvTransmit, &Loc_xAttempt);
+	pthread_join(Loc_xThread, nullptr);
+
+	HOST_vCheck(Loc_xAttempt.u8Status == SPI_STATUS_BUSY, "status: contender sees SPI_STATUS_BUSY");
+	HOST_vCheck(SPI_u8GetLastStatus(SPI2) == SPI_STATUS_OK, "status: owner status untouched by the contender");
+
+	SPI_vRelease(SPI2);
+}
+
+int main(void)
+{
+	HOST_Task_t Loc_xLow, Loc_xMid, Loc_xHigh;
+
+	Loc_xLow.u8Priority = 1U;
+	Loc_xMid.u8Priority = 5U;
+	Loc_xHigh.u8Priority = 7U;
+
+	Glo_pxSelf = &Loc_xLow;
+	SPI_vSetPort(&Glo_xPort);
+
+	HOST_vRecursionAndTimeout(&Loc_xLow, &Loc_xMid);
+	HOST_vInheritance(&Loc_xLow, &Loc_xHigh);
+	HOST_vInheritanceSeveralLocks(&Loc_xLow, &Loc_xMid, &Loc_xHigh);
+	HOST_vStatus(&Loc_xMid);
+
+	printf("%u check(s) failed\n", Glo_u32Failed);
+
+	return (int)Glo_u32Failed;
+}
@@ -0,0 +1,529 @@
+/************************************************************************************
+ * Author: Khooly																	*
+ * Date: 19 March 2024																*
+ * Version: 0.1																		*
+ ***********************************************************************************/
+
+/************************************************************************************
+ * Host side decoder and replayer of the SPI driver trace ring (SPI_TRACE_ENABLE).	*
+ *																					*
+ * Build:	g++ -std=c++11 -O2 -o SPI_trace_host SPI_trace_host.cpp					*
+ * Usage:	SPI_trace_host decode <dump.bin>										*
+ *			SPI_trace_host replay <dump.bin> <pclk_hz> [loop_cycles] [prescaler]	*
+ *																					*
+ * The dump is any memory image holding the ring, for example the bytes returned	*
+ * by SPI_pvGetTrace sent over UART, or a debugger dump of the RAM.					*
+ * replay runs every master transfer again against a simulated SPI_t block using	*
+ * the same polling loops as the driver, loop_cycles is the PCLK cycles spent per	*
+ * loop iteration (at least 1, default 16) and prescaler overrides the recorded		*
+ * BR, a value of @ref SPI_BaudRate_Prescaler, to evaluate a faster or slower bus	*
+ * offline.																			*
+ * Slots of transfers still running when the dump was taken are left out.			*
+ ***********************************************************************************/
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "../SPI_interface.h"
+/* SPI_private.h declares the driver static helpers, they are not needed here */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "../SPI_private.h"
+#pragma GCC diagnostic pop
+
+#define SIM_DEFAULT_LOOP_CYCLES		16U
+#define SIM_NO_PRESCALER_OVERRIDE	0xFFU
+
+/* Simulated SPI peripheral, time is counted in PCLK cycles */
+typedef struct
+{
+	SPI_t		xRegs;
+	uint64_t	u64Cycle;			/* Current time												*/
+	uint64_t	u64ShiftEnd;		/* End of the frame in the shift register					*/
+	uint32_t	u32TxBuffer;		/* Frame waiting in the TX buffer							*/
+	uint32_t	u32Shift;			/* Frame in the shift register								*/
+	bool		boolTxFull;
+	bool		boolShifting;
+}SIM_SPI_t;
+
+/**
+ * @fn uint32_t SIM_u32FrameCycles(const SIM_SPI_t*)
+ * @brief PCLK cycles needed to shift one frame with the current CR1 configuration
+ *
+ * @param Copy_pxSim	Pointer to the simulated peripheral
+ *
+ * @retval Cycles per frame
+ */
+static uint32_t SIM_u32FrameCycles(const SIM_SPI_t* Copy_pxSim)
+{
+	uint32_t Loc_u32Bits = (Copy_pxSim -> xRegs.CR1.BitAccess.DFF == SPI_DATASIZE_16BIT) ? 16U : 8U;
+
+	return Loc_u32Bits << (Copy_pxSim -> xRegs.CR1.BitAccess.BR + 1U);
+}
+
+/**
+ * @fn void SIM_vAdvance(SIM_SPI_t*, uint64_t)
+ * @brief Run the simulated peripheral until a given time, updating TXE, RXNE, OVR and BSY
+ *
+ * @param Copy_pxSim		Pointer to the simulated peripheral
+ * @param Copy_u64Target	Time to reach in PCLK cycles
+ *
+ * @retval None
+ */
+static void SIM_vAdvance(SIM_SPI_t* Copy_pxSim, uint64_t Copy_u64Target)
+{
+	while(true)
+	{
+		/* TX buffer moves to the idle shift register */
+		if((Copy_pxSim -> boolShifting == false) && (Copy_pxSim -> boolTxFull == true))
+		{
+			uint64_t Loc_u64Start = (Copy_pxSim -> u64ShiftEnd > Copy_pxSim -> u64Cycle) ? Copy_pxSim -> u64ShiftEnd : Copy_pxSim -> u64Cycle;
+
+			Copy_pxSim -> u32Shift = Copy_pxSim -> u32TxBuffer;
+			Copy_pxSim -> u64ShiftEnd = Loc_u64Start + SIM_u32FrameCycles(Copy_pxSim);
+			Copy_pxSim -> boolShifting = true;
+			Copy_pxSim -> boolTxFull = false;
+			Copy_pxSim -> xRegs.SR.BitAccess.TXE = 1U;
+			Copy_pxSim -> xRegs.SR.BitAccess.BSY = 1U;
+		}
+		/* Frame completed, the slave is modeled as a loopback */
+		else if((Copy_pxSim -> boolShifting == true) && (Copy_pxSim -> u64ShiftEnd <= Copy_u64Target))
+		{
+			Copy_pxSim -> u64Cycle = Copy_pxSim -> u64ShiftEnd;
+			Copy_pxSim -> boolShifting = false;
+			if(Copy_pxSim -> xRegs.SR.BitAccess.RXNE)
+			{
+				Copy_pxSim -> xRegs.SR.BitAccess.OVR = 1U;
+			}
+			Copy_pxSim -> xRegs.DR = Copy_pxSim -> u32Shift;
+			Copy_pxSim -> xRegs.SR.BitAccess.RXNE = 1U;
+			Copy_pxSim -> xRegs.SR.BitAccess.BSY = Copy_pxSim -> boolTxFull;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if(Copy_u64Target > Copy_pxSim -> u64Cycle)
+	{
+		Copy_pxSim -> u64Cycle = Copy_u64Target;
+	}
+}
+
+/**
+ * @fn void SIM_vWriteDR(SIM_SPI_t*, uint32_t)
+ * @brief Write a frame to the simulated DR
+ *
+ * @param Copy_pxSim		Pointer to the simulated peripheral
+ * @param Copy_u32Data		Frame to send
+ *
+ * @retval None
+ */
+static void SIM_vWriteDR(SIM_SPI_t* Copy_pxSim, uint32_t Copy_u32Data)
+{
+	Copy_pxSim -> u32TxBuffer = Copy_u32Data;
+	Copy_pxSim -> boolTxFull = true;
+	Copy_pxSim -> xRegs.SR.BitAccess.TXE = 0U;
+	SIM_vAdvance(Copy_pxSim, Copy_pxSim -> u64Cycle);
+}
+
+/**
+ * @fn uint32_t SIM_u32ReadDR(SIM_SPI_t*)
+ * @brief Read a frame from the simulated DR
+ *
+ * @param Copy_pxSim		Pointer to the simulated peripheral
+ *
+ * @retval Received frame
+ */
+static uint32_t SIM_u32ReadDR(SIM_SPI_t* Copy_pxSim)
+{
+	Copy_pxSim -> xRegs.SR.BitAccess.RXNE = 0U;
+	return Copy_pxSim -> xRegs.DR;
+}
+
+/**
+ * @fn uint64_t SIM_u64Replay(SIM_SPI_t*, const SPI_TraceRecord_t*, uint8_t, uint32_t)
+ * @brief Run one traced master transfer on the simulated peripheral with the driver polling loops
+ *
+ * @param Copy_pxSim			Pointer to the simulated peripheral
+ * @param Copy_pxRecord			Pointer to the traced transfer
+ * @param Copy_u8Prescaler		BR to use, SIM_NO_PRESCALER_OVERRIDE keeps the traced one
+ * @param Copy_u32LoopCycles	PCLK cycles spent by one iteration of the driver loop
+ *
+ * @retval Duration of the transfer in PCLK cycles, until the driver returns
+ */
+static uint64_t SIM_u64Replay(SIM_SPI_t* Copy_pxSim, const SPI_TraceRecord_t* Copy_pxRecord, uint8_t Copy_u8Prescaler, uint32_t Copy_u32LoopCycles)
+{
+	uint64_t Loc_u64Start;
+	uint16_t Loc_u16TxSize = Copy_pxRecord -> u16Transferred;
+	uint16_t Loc_u16RxSize = Copy_pxRecord -> u16Transferred;
+	bool Loc_boolTxAllowed = true;
+	uint8_t Loc_u8Operation = (Copy_pxRecord -> u8Info >> 2) & 0x03U;
+
+	/* Let the previous transfer drain, a new transfer can not start before the bus is free */
+	SIM_vAdvance(Copy_pxSim, (Copy_pxSim -> u64ShiftEnd > Copy_pxSim -> u64Cycle) ? Copy_pxSim -> u64ShiftEnd : Copy_pxSim -> u64Cycle);
+	SIM_u32ReadDR(Copy_pxSim);
+	Copy_pxSim -> xRegs.SR.BitAccess.OVR = 0U;
+
+	Copy_pxSim -> xRegs.CR1.RegisterAccess = Copy_pxRecord -> u16CR1;
+	if(Copy_u8Prescaler != SIM_NO_PRESCALER_OVERRIDE)
+	{
+		Copy_pxSim -> xRegs.CR1.BitAccess.BR = Copy_u8Prescaler;
+	}
+
+	Loc_u64Start = Copy_pxSim -> u64Cycle;
+
+	if(Loc_u8Operation == SPI_TRACE_OP_TX)
+	{
+		while(Loc_u16TxSize > 0U)
+		{
+			if(Copy_pxSim -> xRegs.SR.BitAccess.TXE)
+			{
+				SIM_vWriteDR(Copy_pxSim, 0U);
+				Loc_u16TxSize--;
+			}
+			SIM_vAdvance(Copy_pxSim, Copy_pxSim -> u64Cycle + Copy_u32LoopCycles);
+		}
+	}
+	else
+	{
+		while((Loc_u16TxSize > 0U) || (Loc_u16RxSize > 0U))
+		{
+			if((Copy_pxSim -> xRegs.SR.BitAccess.TXE) && (Loc_u16TxSize > 0U) && (Loc_boolTxAllowed == true))
+			{
+				SIM_vWriteDR(Copy_pxSim, 0U);
+				Loc_u16TxSize--;
+				Loc_boolTxAllowed = false;
+			}
+			if((Copy_pxSim -> xRegs.SR.BitAccess.RXNE) && (Loc_u16RxSize > 0U))
+			{
+				SIM_u32ReadDR(Copy_pxSim);
+				Loc_u16RxSize--;
+				Loc_boolTxAllowed = true;
+			}
+			SIM_vAdvance(Copy_pxSim, Copy_pxSim -> u64Cycle + Copy_u32LoopCycles);
+		}
+	}
+
+	return Copy_pxSim -> u64Cycle - Loc_u64Start;
+}
+
+/**
+ * @fn const uint8_t* TRACE_pu8Find(const std::vector<uint8_t>&)
+ * @brief Locate the trace ring inside a memory dump
+ *
+ * @param Copy_xDump	Dump content
+ *
+ * @retval Pointer to the SPI_TraceHeader_t, nullptr if no valid ring is found
+ */
+static const uint8_t* TRACE_pu8Find(const std::vector<uint8_t>& Copy_xDump)
+{
+	const uint8_t* Loc_pu8Header = nullptr;
+	size_t Loc_Offset;
+
+	for(Loc_Offset = 0U; (Loc_Offset + sizeof(SPI_TraceHeader_t)) <= Copy_xDump.size(); Loc_Offset += 4U)
+	{
+		SPI_TraceHeader_t Loc_xHeader;
+		memcpy(&Loc_xHeader, &Copy_xDump[Loc_Offset], sizeof(Loc_xHeader));
+
+		/* The payload must fit in the slot and the slots in the dump, the decoder reads both */
+		if((Loc_xHeader.u32Magic == SPI_TRACE_MAGIC) && (Loc_xHeader.u8Version == SPI_TRACE_VERSION) &&
+		   (Loc_xHeader.u8RecordSize >= sizeof(SPI_TraceRecord_t)) && (Loc_xHeader.u16Depth != 0U) &&
+		   (Loc_xHeader.u8DataBytes <= (Loc_xHeader.u8RecordSize - sizeof(SPI_TraceRecord_t))) &&
+		   ((Loc_Offset + sizeof(SPI_TraceHeader_t) + ((size_t)Loc_xHeader.u16Depth * Loc_xHeader.u8RecordSize)) <= Copy_xDump.size()))
+		{
+			Loc_pu8Header = &Copy_xDump[Loc_Offset];
+			break;
+		}
+	}
+
+	return Loc_pu8Header;
+}
+
+/**
+ * @fn uint32_t TRACE_u32Records(const uint8_t*, SPI_TraceHeader_t*, std::vector<const uint8_t*>&)
+ * @brief List the valid slots of the ring from the oldest to the newest, a slot without
+ * SPI_TRACE_INFO_COMPLETE was being written when the dump was taken and is left out
+ *
+ * @param Copy_pu8Header	Pointer to the ring
+ * @param Copy_pxHeader		Pointer to the returned header
+ * @param Copy_xSlots		Returned slots
+ *
+ * @retval Number of incomplete slots left out
+ */
+static uint32_t TRACE_u32Records(const uint8_t* Copy_pu8Header, SPI_TraceHeader_t* Copy_pxHeader, std::vector<const uint8_t*>& Copy_xSlots)
+{
+	uint32_t Loc_u32Incomplete = 0U;
+
+	memcpy(Copy_pxHeader, Copy_pu8Header, sizeof(SPI_TraceHeader_t));
+
+	uint32_t Loc_u32Valid = (Copy_pxHeader -> u32Count < Copy_pxHeader -> u16Depth) ? Copy_pxHeader -> u32Count : Copy_pxHeader -> u16Depth;
+	uint32_t Loc_u32First = Copy_pxHeader -> u32Count - Loc_u32Valid;
+	uint32_t Loc_u32Index;
+
+	for(Loc_u32Index = 0U; Loc_u32Index < Loc_u32Valid; Loc_u32Index++)
+	{
+		uint32_t Loc_u32Slot = (Loc_u32First + Loc_u32Index) % Copy_pxHeader -> u16Depth;
+		const uint8_t* Loc_pu8Slot = Copy_pu8Header + sizeof(SPI_TraceHeader_t) + ((size_t)Loc_u32Slot * Copy_pxHeader -> u8RecordSize);
+
+		if((Loc_pu8Slot[offsetof(SPI_TraceRecord_t, u8Info)] & SPI_TRACE_INFO_COMPLETE) != 0U)
+		{
+			Copy_xSlots.push_back(Loc_pu8Slot);
+		}
+		else
+		{
+			Loc_u32Incomplete++;
+		}
+	}
+
+	return Loc_u32Incomplete;
+}
+
+/**
+ * @fn void TRACE_vPrintData(const char*, const uint8_t*, uint32_t)
+ * @brief Print captured payload bytes in hex
+ *
+ * @retval None
+ */
+static void TRACE_vPrintData(const char* Copy_pcLabel, const uint8_t* Copy_pu8Data, uint32_t Copy_u32Bytes)
+{
+	uint32_t Loc_u32Index;
+
+	printf("    %s", Copy_pcLabel);
+	for(Loc_u32Index = 0U; Loc_u32Index < Copy_u32Bytes; Loc_u32Index++)
+	{
+		printf(" %02X", Copy_pu8Data[Loc_u32Index]);
+	}
+	printf("\n");
+}
+
+/**
+ * @fn int TRACE_iDecode(const uint8_t*)
+ * @brief Print every traced transfer with its timing and configuration
+ *
+ * @retval Process exit code
+ */
+static int TRACE_iDecode(const uint8_t* Copy_pu8Header)
+{
+	static const char* const Loc_apcOperation[] = {"TX", "RX", "TXRX", "?"};
+	static const char* const Loc_apcStatus[] = {"OK", "TIMEOUT", "BUSY", "INVALID", "OVERRUN"};
+	SPI_TraceHeader_t Loc_xHeader;
+	std::vector<const uint8_t*> Loc_xSlots;
+	uint32_t Loc_u32PrevEnd = 0U;
+	size_t Loc_Index;
+
+	uint32_t Loc_u32Incomplete = TRACE_u32Records(Copy_pu8Header, &Loc_xHeader, Loc_xSlots);
+
+	printf("trace v%u: %u slots of %u bytes, %u data bytes, %u records written, %u kept, %u in progress\n",
+			Loc_xHeader.u8Version, Loc_xHeader.u16Depth, Loc_xHeader.u8RecordSize, Loc_xHeader.u8DataBytes,
+			Loc_xHeader.u32Count, (unsigned)Loc_xSlots.size(), Loc_u32Incomplete);
+	printf("%6s %10s %8s %8s %4s %4s %3s %3s %4s %5s %6s %s\n",
+			"#", "start_us", "dur_us", "gap_us", "spi", "op", "br", "dff", "mode", "len", "done", "status");
+
+	for(Loc_Index = 0U; Loc_Index < Loc_xSlots.size(); Loc_Index++)
+	{
+		SPI_TraceRecord_t Loc_xRecord;
+		CR1_Reg_t Loc_xCR1;
+
+		memcpy(&Loc_xRecord, Loc_xSlots[Loc_Index], sizeof(Loc_xRecord));
+		Loc_xCR1.RegisterAccess = Loc_xRecord.u16CR1;
+
+		uint8_t Loc_u8Operation = (Loc_xRecord.u8Info >> 2) & 0x03U;
+
+		printf("%6u %10u %8u %8d %4u %4s %3u %3u %2u%2s %5u %6u %s\n",
+				(unsigned)Loc_Index, Loc_xRecord.u32StartUs, Loc_xRecord.u32EndUs - Loc_xRecord.u32StartUs,
+				(Loc_Index == 0U) ? 0 : (int32_t)(Loc_xRecord.u32StartUs - Loc_u32PrevEnd),
+				Loc_xRecord.u8Info & 0x03U, Loc_apcOperation[Loc_u8Operation],
+				(unsigned)Loc_xCR1.BitAccess.BR, (unsigned)Loc_xCR1.BitAccess.DFF,
+				(unsigned)((Loc_xCR1.BitAccess.CPOL << 1) | Loc_xCR1.BitAccess.CPHA), Loc_xCR1.BitAccess.MSTR ? "M" : "S",
+				Loc_xRecord.u16ElementsNo, Loc_xRecord.u16Transferred,
+				(Loc_xRecord.u8Status <= SPI_STATUS_OVERRUN) ? Loc_apcStatus[Loc_xRecord.u8Status] : "?");
+
+		if(Loc_xHeader.u8DataBytes > 0U)
+		{
+			const uint8_t* Loc_pu8Data = Loc_xSlots[Loc_Index] + sizeof(SPI_TraceRecord_t);
+			uint32_t Loc_u32Bytes = (uint32_t)Loc_xRecord.u16Transferred << Loc_xCR1.BitAccess.DFF;
+			uint32_t Loc_u32Half = Loc_xHeader.u8DataBytes / 2U;
+
+			if(Loc_u8Operation == SPI_TRACE_OP_TX_RX)
+			{
+				TRACE_vPrintData("tx:", Loc_pu8Data, (Loc_u32Bytes < Loc_u32Half) ? Loc_u32Bytes : Loc_u32Half);
+				TRACE_vPrintData("rx:", Loc_pu8Data + Loc_u32Half,
+						(Loc_u32Bytes < (Loc_xHeader.u8DataBytes - Loc_u32Half)) ? Loc_u32Bytes : (Loc_xHeader.u8DataBytes - Loc_u32Half));
+			}
+			else
+			{
+				TRACE_vPrintData((Loc_u8Operation == SPI_TRACE_OP_TX) ? "tx:" : "rx:", Loc_pu8Data,
+						(Loc_u32Bytes < Loc_xHeader.u8DataBytes) ? Loc_u32Bytes : Loc_xHeader.u8DataBytes);
+			}
+		}
+
+		Loc_u32PrevEnd = Loc_xRecord.u32EndUs;
+	}
+
+	return 0;
+}
+
+/**
+ * @fn int TRACE_iReplay(const uint8_t*, uint32_t, uint32_t, uint8_t)
+ * @brief Replay the traced master transfers on a simulated SPI_t and compare with the recorded timing
+ *
+ * @retval Process exit code
+ */
+static int TRACE_iReplay(const uint8_t* Copy_pu8Header, uint32_t Copy_u32PclkHz, uint32_t Copy_u32LoopCycles, uint8_t Copy_u8Prescaler)
+{
+	SPI_TraceHeader_t Loc_xHeader;
+	std::vector<const uint8_t*> Loc_xSlots;
+	SIM_SPI_t Loc_axSim[SPI_INSTANCES_NO] = {};
+	uint64_t Loc_u64RecordedUs = 0U, Loc_u64SimCycles = 0U, Loc_u64WireCycles = 0U, Loc_u64Bytes = 0U;
+	uint32_t Loc_u32Skipped = 0U;
+	size_t Loc_Index;
+
+	for(Loc_Index = 0U; Loc_Index < SPI_INSTANCES_NO; Loc_Index++)
+	{
+		Loc_axSim[Loc_Index].xRegs.SR.BitAccess.TXE = 1U;
+	}
+
+	(void)TRACE_u32Records(Copy_pu8Header, &Loc_xHeader, Loc_xSlots);
+
+	printf("%6s %4s %5s %10s %10s %10s\n", "#", "spi", "len", "trace_us", "sim_us", "wire_us");
+
+	for(Loc_Index = 0U; Loc_Index < Loc_xSlots.size(); Loc_Index++)
+	{
+		SPI_TraceRecord_t Loc_xRecord;
+		CR1_Reg_t Loc_xCR1;
+
+		memcpy(&Loc_xRecord, Loc_xSlots[Loc_Index], sizeof(Loc_xRecord));
+		Loc_xCR1.RegisterAccess = Loc_xRecord.u16CR1;
+
+		uint8_t Loc_u8SPIx = Loc_xRecord.u8Info & 0x03U;
+
+		/* In slave mode the timing belongs to the external master, nothing to simulate */
+		if((Loc_xCR1.BitAccess.MSTR != SPI_MODE_MASTER) || (Loc_u8SPIx < SPI1) || (Loc_u8SPIx > SPI3))
+		{
+			Loc_u32Skipped++;
+			continue;
+		}
+
+		SIM_SPI_t* Loc_pxSim = &Loc_axSim[SPI_INDEX(Loc_u8SPIx)];
+		uint64_t Loc_u64Cycles = SIM_u64Replay(Loc_pxSim, &Loc_xRecord, Copy_u8Prescaler, Copy_u32LoopCycles);
+		uint64_t Loc_u64Wire = (uint64_t)Loc_xRecord.u16Transferred * SIM_u32FrameCycles(Loc_pxSim);
+		uint32_t Loc_u32TraceUs = Loc_xRecord.u32EndUs - Loc_xRecord.u32StartUs;
+
+		printf("%6u %4u %5u %10u %10.1f %10.1f\n", (unsigned)Loc_Index, Loc_u8SPIx, Loc_xRecord.u16Transferred, Loc_u32TraceUs,
+				(Loc_u64Cycles * 1e6) / Copy_u32PclkHz, (Loc_u64Wire * 1e6) / Copy_u32PclkHz);
+
+		Loc_u64RecordedUs += Loc_u32TraceUs;
+		Loc_u64SimCycles += Loc_u64Cycles;
+		Loc_u64WireCycles += Loc_u64Wire;
+		Loc_u64Bytes += (uint64_t)Loc_xRecord.u16Transferred << Loc_xCR1.BitAccess.DFF;
+	}
+
+	double Loc_f64SimUs = (Loc_u64SimCycles * 1e6) / Copy_u32PclkHz;
+	double Loc_f64WireUs = (Loc_u64WireCycles * 1e6) / Copy_u32PclkHz;
+
+	printf("\n%llu bytes, %u slave records skipped\n", (unsigned long long)Loc_u64Bytes, Loc_u32Skipped);
+	printf("recorded  %12llu us  %8.3f MB/s\n", (unsigned long long)Loc_u64RecordedUs,
+			(Loc_u64RecordedUs != 0U) ? (double)Loc_u64Bytes / Loc_u64RecordedUs : 0.0);
+	printf("simulated %12.1f us  %8.3f MB/s\n", Loc_f64SimUs, (Loc_f64SimUs > 0.0) ? Loc_u64Bytes / Loc_f64SimUs : 0.0);
+	printf("wire only %12.1f us  %8.3f MB/s\n", Loc_f64WireUs, (Loc_f64WireUs > 0.0) ? Loc_u64Bytes / Loc_f64WireUs : 0.0);
+
+	return 0;
+}
+
+/**
+ * @fn bool TRACE_boolParse(const char*, uint32_t*)
+ * @brief Parse a decimal, hexadecimal (0x) or octal (0) command line number
+ *
+ * @param Copy_pcText		Command line argument
+ * @param Copy_pu32Value	Pointer to the returned value
+ *
+ * @retval false if the argument is not a complete 32 bit number
+ */
+static bool TRACE_boolParse(const char* Copy_pcText, uint32_t* Copy_pu32Value)
+{
+	char* Loc_pcEnd = nullptr;
+	unsigned long long Loc_Value;
+
+	errno = 0;
+	Loc_Value = strtoull(Copy_pcText, &Loc_pcEnd, 0);
+
+	if((errno != 0) || (Loc_pcEnd == Copy_pcText) || (*Loc_pcEnd != '\0') || (Copy_pcText[0] == '-') || (Loc_Value > UINT32_MAX))
+	{
+		return false;
+	}
+
+	*Copy_pu32Value = (uint32_t)Loc_Value;
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	int Loc_iResult = 1;
+
+	if((argc < 3) || ((strcmp(argv[1], "decode") != 0) && (strcmp(argv[1], "replay") != 0)) ||
+	   ((strcmp(argv[1], "replay") == 0) && (argc < 4)))
+	{
+		fprintf(stderr, "usage: %s decode <dump.bin>\n"
+						"       %s replay <dump.bin> <pclk_hz> [loop_cycles] [prescaler]\n", argv[0], argv[0]);
+		return Loc_iResult;
+	}
+
+	FILE* Loc_pxFile = fopen(argv[2], "rb");
+	if(Loc_pxFile == nullptr)
+	{
+		perror(argv[2]);
+		return Loc_iResult;
+	}
+
+	std::vector<uint8_t> Loc_xDump;
+	uint8_t Loc_au8Chunk[4096];
+	size_t Loc_Read;
+	while((Loc_Read = fread(Loc_au8Chunk, 1U, sizeof(Loc_au8Chunk), Loc_pxFile)) > 0U)
+	{
+		Loc_xDump.insert(Loc_xDump.end(), Loc_au8Chunk, Loc_au8Chunk + Loc_Read);
+	}
+	fclose(Loc_pxFile);
+
+	const uint8_t* Loc_pu8Header = TRACE_pu8Find(Loc_xDump);
+
+	if(Loc_pu8Header == nullptr)
+	{
+		fprintf(stderr, "%s: no SPI trace ring found\n", argv[2]);
+	}
+	else if(strcmp(argv[1], "decode") == 0)
+	{
+		Loc_iResult = TRACE_iDecode(Loc_pu8Header);
+	}
+	else
+	{
+		uint32_t Loc_u32PclkHz = 0U;
+		uint32_t Loc_u32LoopCycles = SIM_DEFAULT_LOOP_CYCLES;
+		uint32_t Loc_u32Prescaler = SIM_NO_PRESCALER_OVERRIDE;
+
+		if((TRACE_boolParse(argv[3], &Loc_u32PclkHz) == false) || (Loc_u32PclkHz == 0U))
+		{
+			fprintf(stderr, "invalid pclk_hz '%s'\n", argv[3]);
+		}
+		/* At least one cycle per loop iteration, the simulated time would never advance otherwise */
+		else if((argc > 4) && ((TRACE_boolParse(argv[4], &Loc_u32LoopCycles) == false) || (Loc_u32LoopCycles == 0U)))
+		{
+			fprintf(stderr, "invalid loop_cycles '%s', must be at least 1\n", argv[4]);
+		}
+		else if((argc > 5) && ((TRACE_boolParse(argv[5], &Loc_u32Prescaler) == false) || (Loc_u32Prescaler > SPI_CLOCK_RATE_FREQ_DIVID_BY_256)))
+		{
+			fprintf(stderr, "invalid prescaler '%s', must be 0 to 7\n", argv[5]);
+		}
+		else
+		{
+			Loc_iResult = TRACE_iReplay(Loc_pu8Header, Loc_u32PclkHz, Loc_u32LoopCycles, (uint8_t)Loc_u32Prescaler);
+		}
+	}
+
+	return Loc_iResult;
+}
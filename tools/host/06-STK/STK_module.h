@@ -0,0 +1,12 @@
+/************************************************************************************
+ * Host build stand-in of STK_module.h, micros() is defined by each host tool.		*
+ ***********************************************************************************/
+
+#ifndef STK_MODULE_H
+#define STK_MODULE_H
+
+#include <stdint.h>
+
+uint64_t micros(void);
+
+#endif
@@ -0,0 +1,10 @@
+/************************************************************************************
+ * Host build stand-in of BIT_MATH.h, the driver does not use its macros.			*
+ * Build the host tools with -Itools/host/inc so that "../06-STK/STK_module.h"		*
+ * resolves to tools/host/06-STK/STK_module.h.										*
+ ***********************************************************************************/
+
+#ifndef BIT_MATH_H
+#define BIT_MATH_H
+
+#endif